@@ -9,21 +9,26 @@
 #include <linux/cdev.h>
 #include <linux/ktime.h>
 #include "nxp_simtemp_ioctl.h"
-
-#define SIMTEMP_BUFFER_SIZE 16   // ring buffer size
-
-//Simulation modes as required by the challenge
-enum simtemp_mode {
-    SIMTEMP_MODE_NORMAL, // e.g., 25-35 C
-    SIMTEMP_MODE_NOISY,  // e.g., 20-40 C
-    SIMTEMP_MODE_RAMP,   // e.g., ramp up
-};
+#include "nxp_simtemp_netlink.h"
+#include "simtemp_core.h"   // Rings, generator and threshold logic
 
 // Statistics structure as required by the challenge
 struct simtemp_stats {
     __u64 samples_generated;
     __u64 alerts_triggered;
     __u64 read_errors;
+    __u64 ticks;            // timer callbacks (samples or frames generated)
+};
+
+// Running aggregate published over generic netlink every N samples
+struct simtemp_aggregate {
+    __u64 first_ts_ns;
+    __u64 last_ts_ns;
+    __s64 sum_mC;
+    __s32 min_mC;
+    __s32 max_mC;
+    __u32 count;
+    __u32 alerts;
 };
 
 // Structure for representing the simulated temperature device
@@ -34,10 +39,7 @@ struct simtemp_dev {
     dev_t dev_num;
 
     // Ring buffer
-    struct simtemp_sample buffer[SIMTEMP_BUFFER_SIZE];
-    int head;
-    int tail;
-    int count;
+    struct simtemp_ring ring;
 
     // for locking buffer reading
     spinlock_t lock;    
@@ -58,6 +60,27 @@ struct simtemp_dev {
     enum simtemp_mode mode;     // Current simulation mode
     struct simtemp_stats stats; // Statistics counters
 
+    // Multi-channel mode (channels > 1 switches read() to SoA frames)
+    unsigned int channels;
+    int channel_threshold_mC[SIMTEMP_MAX_CHANNELS];
+    u32 channel_alert_mask;     // channels currently at/below threshold
+    struct simtemp_frame_ring frames;
+    s32 last_temp_mC[SIMTEMP_MAX_CHANNELS];  // newest frame, even if not queued
+
+    // Adaptive sampling (policy OFF = fixed interval_ms)
+    struct simtemp_adaptive adaptive;
+    unsigned int effective_ms;  // period of the next tick
+    int avg_temp_mC[SIMTEMP_MAX_CHANNELS];  // smoothed, for the slope test
+    unsigned int avg_channels;  // channels avg_temp_mC was seeded for (0 = none)
+    u64 start_ns;               // probe time, for the average rate in stats
+
+    // History ring: written on every tick, never consumed (GET_HISTORY)
+    struct simtemp_history history;
+
+    // Generic netlink aggregates (0 = disabled)
+    unsigned int nl_aggregate_samples;
+    struct simtemp_aggregate agg;
+
 };
 
 // For forcing 0666 for device file priviledge (non root)
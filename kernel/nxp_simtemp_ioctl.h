@@ -15,6 +15,26 @@ struct simtemp_sample {
 #define SIMTEMP_FLAG_THRESHOLD_CROSSED (1 << 1)
 
 
+// Multi-channel mode (sysfs channels > 1): read() returns a batch of frames
+// in struct-of-arrays layout so consumers can process each block with SIMD:
+//
+//   struct simtemp_frame_hdr hdr;
+//   __u64 timestamp_ns[nframes];        one shared timestamp per frame
+//   __u32 alert_mask[nframes];          bit c = channel c at/below its threshold
+//   __s32 temp_mC[channels][nframes];   one contiguous block per channel
+//
+// read() len must hold at least one frame; as many frames as fit are returned.
+#define SIMTEMP_MAX_CHANNELS 32
+
+struct simtemp_frame_hdr {
+    __u32 channels;
+    __u32 nframes;
+};
+
+#define SIMTEMP_FRAME_STRIDE(ch) (sizeof(__u64) + sizeof(__u32) + (ch) * sizeof(__s32))
+#define SIMTEMP_FRAME_BYTES(ch, n) \
+    (sizeof(struct simtemp_frame_hdr) + (n) * SIMTEMP_FRAME_STRIDE(ch))
+
 // ioctl definitions (for atomic config)
 #define SIMTEMP_IOC_MAGIC 'p'
 
@@ -27,5 +47,44 @@ struct simtemp_config {
 #define SIMTEMP_IOC_SET_CONFIG _IOW(SIMTEMP_IOC_MAGIC, 1, struct simtemp_config)
 #define SIMTEMP_IOC_GET_CONFIG _IOR(SIMTEMP_IOC_MAGIC, 2, struct simtemp_config)
 
+// Struct for draining several records in one syscall (single-channel mode).
+// Blocks like read() until at least one sample is queued (unless O_NONBLOCK).
+struct simtemp_batch {
+    __u64 samples;      /* user pointer to struct simtemp_sample[max_samples] */
+    __u32 max_samples;  /* in: capacity of 'samples' */
+    __u32 count;        /* out: records copied */
+};
+
+#define SIMTEMP_IOC_READ_BATCH _IOWR(SIMTEMP_IOC_MAGIC, 3, struct simtemp_batch)
+
+// Non-consuming peek at the last 'max_samples' ticks (oldest first), taken
+// from a history ring separate from (and larger than) the read() ring.
+// Never blocks; 'count' may be smaller than requested early after load.
+#define SIMTEMP_HISTORY_SIZE 1024
+
+#define SIMTEMP_IOC_GET_HISTORY _IOWR(SIMTEMP_IOC_MAGIC, 4, struct simtemp_batch)
+
+// Adaptive sampling: the period shrinks while the temperature is within
+// band_mC of the threshold or its smoothed value (EWMA, 1/16 per tick) moves
+// by >= slope_mC per tick, and grows by step_ms per calm tick, always
+// clamped to [min_ms, max_ms].
+enum simtemp_adaptive_policy {
+    SIMTEMP_ADAPTIVE_OFF,   // fixed sampling_ms
+    SIMTEMP_ADAPTIVE_JUMP,  // urgent -> min_ms immediately
+    SIMTEMP_ADAPTIVE_HALVE, // urgent -> period / 2 per tick
+};
+
+struct simtemp_adaptive {
+    __u32 policy;       // enum simtemp_adaptive_policy
+    __u32 min_ms;       // fastest period (1..10000)
+    __u32 max_ms;       // slowest period (min_ms..10000)
+    __u32 step_ms;      // growth per calm tick (1..10000)
+    __s32 band_mC;      // "near threshold" distance (>= 0)
+    __s32 slope_mC;     // "changing fast" per-tick move of the EWMA (> 0)
+};
+
+#define SIMTEMP_IOC_SET_ADAPTIVE _IOW(SIMTEMP_IOC_MAGIC, 5, struct simtemp_adaptive)
+#define SIMTEMP_IOC_GET_ADAPTIVE _IOR(SIMTEMP_IOC_MAGIC, 6, struct simtemp_adaptive)
+
 
 #endif // NXP_SIMTEMP_IOCTL_H
\ No newline at end of file
@@ -0,0 +1,1498 @@
+#include <linux/module.h>      
+#include <linux/init.h> 
+#include <linux/fs.h>          // For alloc_chrdev_region, file_operations
+#include <linux/cdev.h>        // For cdev functions
+#include <linux/device.h>      // For class_create and device_create
+#include <linux/uaccess.h>     // For copy_to_user (for user space)
+#include <linux/jiffies.h>     // For jiffies (time tick counter) (used for simulating temperature variation)
+#include <linux/version.h>     // For class create differences
+#include <linux/random.h>      // For random numb generation (temp generation)
+#include <linux/poll.h>        // FOr polling inclusion
+
+//Headers required for platform driver and Device Tree
+#include <linux/platform_device.h> // For platform_driver
+#include <linux/of.h>            // For Device Tree functions (of_property_read)
+#include <linux/ktime.h>         // For ktime_get_ns()
+#include <linux/math64.h>        // For div_s64() (aggregate mean)
+#include <linux/slab.h>          // For kmalloc() (frame read bounce buffer)
+#include <linux/bitops.h>        // For hweight32()/__ffs() (channel alert masks)
+
+// Generic netlink multicast channel (alerts + aggregates)
+#include <net/genetlink.h>
+
+#include "nxp_simtemp.h"
+
+#define DEVICE_NAME "simtemp"
+#define CLASS_NAME  "simtemp"          
+
+#define TEST 1
+
+#if TEST
+    // Struct for test
+    static struct platform_device *simtemp_pdev_test;
+#endif
+// Function prototypes (file operations)
+static int simtemp_open(struct inode *inode, struct file *file);
+static int simtemp_release(struct inode *inode, struct file *file);
+static ssize_t simtemp_read(struct file *file, char __user *buf, size_t len, loff_t *offset);
+static __poll_t simtemp_poll(struct file *file, poll_table *wait);
+// Prototype for ioctl
+static long simtemp_ioctl(struct file *file, unsigned int cmd, unsigned long arg);
+
+// Prototypes for platform driver functions
+static int simtemp_probe(struct platform_device *pdev);
+static void simtemp_remove(struct platform_device *pdev);
+
+
+// Sysfs attribute handlers
+static ssize_t sampling_ms_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t sampling_ms_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t temperature_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t threshold_flag_show(struct device *dev, struct device_attribute *attr, char *buf);
+
+// For Treshold sysfs attribute handler
+static ssize_t threshold_mC_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t threshold_mC_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+
+// Prototypes for sysfs files (mode, stats)
+static ssize_t mode_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t mode_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t stats_show(struct device *dev, struct device_attribute *attr, char *buf);
+
+// Prototypes for netlink aggregate window (samples per record, 0 = off)
+static ssize_t nl_aggregate_samples_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t nl_aggregate_samples_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+
+// Prototypes for multi-channel mode (channel count, per-channel thresholds)
+static ssize_t channels_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t channels_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t channel_thresholds_mC_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t channel_thresholds_mC_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+
+// Prototypes for adaptive sampling
+static ssize_t adaptive_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t adaptive_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t adaptive_min_ms_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t adaptive_min_ms_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t adaptive_max_ms_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t adaptive_max_ms_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t adaptive_step_ms_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t adaptive_step_ms_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t adaptive_band_mC_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t adaptive_band_mC_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+static ssize_t adaptive_slope_mC_show(struct device *dev, struct device_attribute *attr, char *buf);
+static ssize_t adaptive_slope_mC_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+
+
+// Sysfs attribute creation
+static DEVICE_ATTR_RW(sampling_ms);
+static DEVICE_ATTR_RO(temperature);
+static DEVICE_ATTR_RO(threshold_flag);
+static DEVICE_ATTR_RW(threshold_mC);
+
+// Attributes for mode and stats
+static DEVICE_ATTR_RW(mode);
+static DEVICE_ATTR_RO(stats);
+static DEVICE_ATTR_RW(nl_aggregate_samples);
+
+// Attributes for multi-channel mode
+static DEVICE_ATTR_RW(channels);
+static DEVICE_ATTR_RW(channel_thresholds_mC);
+
+// Attributes for adaptive sampling
+static DEVICE_ATTR_RW(adaptive);
+static DEVICE_ATTR_RW(adaptive_min_ms);
+static DEVICE_ATTR_RW(adaptive_max_ms);
+static DEVICE_ATTR_RW(adaptive_step_ms);
+static DEVICE_ATTR_RW(adaptive_band_mC);
+static DEVICE_ATTR_RW(adaptive_slope_mC);
+
+// Device Tree match table
+static const struct of_device_id simtemp_of_match[] = {
+    { .compatible = "nxp,simtemp" }, // match the DTS file
+    { /* nothing xd */ }
+};
+MODULE_DEVICE_TABLE(of, simtemp_of_match); // Expose table to user space
+
+// Platform driver structure definition
+static struct platform_driver simtemp_platform_driver = {
+    .driver = {
+        .name = DEVICE_NAME,
+        #if TEST
+        .of_match_table = NULL, 
+        #else
+        .of_match_table = simtemp_of_match,// Link to our DT match table (NULL FOR LOCAL TESTING)
+        #endif
+    },
+    .probe = simtemp_probe,   // Called when device is found
+    .remove = simtemp_remove, // Called when device is removed
+};
+
+
+// File operations structure
+static const struct file_operations simtemp_fops = {
+    .owner = THIS_MODULE,
+    .open = simtemp_open,
+    .release = simtemp_release,
+    .read = simtemp_read,
+    .poll = simtemp_poll,
+    .unlocked_ioctl = simtemp_ioctl, // Register the ioctl handler
+};
+
+// Generic netlink multicast group (one group, all devices)
+#define SIMTEMP_NL_GRP_EVENTS 0 // index in simtemp_nl_mcgrps[]
+static const struct genl_multicast_group simtemp_nl_mcgrps[] = {
+    [SIMTEMP_NL_GRP_EVENTS] = { .name = SIMTEMP_NL_MCGRP_NAME },
+};
+
+// Generic netlink family. Notification-only: no ops, the kernel just
+// multicasts, so N subscribers cost one skb and no per-reader state.
+static struct genl_family simtemp_nl_family = {
+    .name = SIMTEMP_NL_FAMILY_NAME,
+    .version = SIMTEMP_NL_VERSION,
+    .maxattr = SIMTEMP_NL_ATTR_MAX,
+    .module = THIS_MODULE,
+    .mcgrps = simtemp_nl_mcgrps,
+    .n_mcgrps = ARRAY_SIZE(simtemp_nl_mcgrps),
+};
+
+// Function for opening the device file
+static int simtemp_open(struct inode *inode, struct file *file)
+{
+    // Get device struct from inodes cdev
+    struct simtemp_dev *dev = container_of(inode->i_cdev, struct simtemp_dev, cdev);
+    
+    // Store the instance-specific 'dev' pointer
+    file->private_data = dev;
+    
+    pr_info("simtemp: device opened\n");
+    return 0;
+}
+
+// Function for releasing the device file
+static int simtemp_release(struct inode *inode, struct file *file)
+{
+    file->private_data = NULL; // Clear private_data
+    pr_info("simtemp: device closed\n");
+    return 0;
+}
+
+// Set the global threshold; it also resets every per-channel threshold.
+// Caller holds dev->lock.
+static void simtemp_set_threshold_locked(struct simtemp_dev *dev, int threshold_mC)
+{
+    int ch;
+
+    dev->threshold_mC = threshold_mC;
+    for (ch = 0; ch < SIMTEMP_MAX_CHANNELS; ch++)
+        dev->channel_threshold_mC[ch] = threshold_mC;
+}
+
+// True if the active ring (samples or frames) has something to read
+static bool simtemp_data_ready(struct simtemp_dev *dev)
+{
+    return dev->channels > 1 ? dev->frames.count > 0 : dev->ring.count > 0;
+}
+
+// Multi-channel read: as many SoA frames as fit in 'len' (see nxp_simtemp_ioctl.h)
+static ssize_t simtemp_read_frames(struct simtemp_dev *dev, struct file *file,
+                                   char __user *buf, size_t len)
+{
+    struct simtemp_frame_hdr *hdr;
+    unsigned int channels, max_frames, nframes;
+    u64 *ts;
+    u32 *mask;
+    s32 *temps;
+    size_t bytes;
+    void *bounce;
+
+again:
+    channels = READ_ONCE(dev->channels);
+
+    // At least one frame must fit
+    if (channels <= 1 || len < SIMTEMP_FRAME_BYTES(channels, 1))
+        return -EINVAL;
+
+    // Wait for data (if blocking)
+    if (!simtemp_data_ready(dev)) {
+        if (file->f_flags & O_NONBLOCK)
+            return -EAGAIN;
+
+        if (wait_event_interruptible(dev->read_queue, simtemp_data_ready(dev)))
+            return -ERESTARTSYS;
+    }
+
+    // Sized for what this read can return, not the worst case
+    max_frames = min_t(size_t, SIMTEMP_FRAME_RING_SIZE,
+                       (len - sizeof(*hdr)) / SIMTEMP_FRAME_STRIDE(channels));
+    bounce = kmalloc(SIMTEMP_FRAME_BYTES(channels, max_frames), GFP_KERNEL);
+    if (!bounce)
+        return -ENOMEM;
+
+    // Extract frames (critical section)
+    spin_lock_bh(&dev->lock);
+
+    if (dev->channels != channels) {
+        // Width changed while we slept: the buffer no longer fits
+        spin_unlock_bh(&dev->lock);
+        kfree(bounce);
+        goto again;
+    }
+
+    nframes = min_t(unsigned int, dev->frames.count, max_frames);
+    if (nframes == 0) {
+        // Another reader got there first: wait again rather than report EOF
+        spin_unlock_bh(&dev->lock);
+        kfree(bounce);
+        goto again;
+    }
+
+    hdr = bounce;
+    hdr->channels = channels;
+    hdr->nframes = nframes;
+    ts = (u64 *)(hdr + 1);
+    mask = (u32 *)(ts + nframes);
+    temps = (s32 *)(mask + nframes);
+
+    simtemp_frame_ring_pop(&dev->frames, channels, nframes, ts, mask, temps);
+
+    spin_unlock_bh(&dev->lock);
+
+    // Copy data to user space
+    bytes = SIMTEMP_FRAME_BYTES(channels, nframes);
+    if (copy_to_user(buf, bounce, bytes)) {
+        pr_warn("simtemp: copy_to_user failed\n");
+        spin_lock_bh(&dev->lock);
+        dev->stats.read_errors++; // Update stats
+        spin_unlock_bh(&dev->lock);
+        kfree(bounce);
+        return -EFAULT;
+    }
+
+    kfree(bounce);
+    return bytes;
+}
+
+// Apply an adaptive config and restart the timer. Caller holds dev->lock.
+static void simtemp_set_adaptive_locked(struct simtemp_dev *dev, const struct simtemp_adaptive *cfg)
+{
+    dev->adaptive = *cfg;
+    if (cfg->policy == SIMTEMP_ADAPTIVE_OFF)
+        dev->effective_ms = dev->interval_ms;
+    else
+        dev->effective_ms = clamp(dev->effective_ms, cfg->min_ms, cfg->max_ms);
+    mod_timer(&dev->timer, jiffies + msecs_to_jiffies(dev->effective_ms));
+}
+
+// Pick the period of the next tick from this tick's temperatures.
+// Caller holds dev->lock; 'n' channels, thresholds in the same order.
+static unsigned int simtemp_adaptive_update_locked(struct simtemp_dev *dev, const s32 *temps,
+                                                   const s32 *thresholds, unsigned int n)
+{
+    unsigned int next;
+
+    // Seed the smoothed temperatures on the first tick and after a width
+    // change, so start-up does not look like a steep slope
+    if (dev->avg_channels != n) {
+        memcpy(dev->avg_temp_mC, temps, n * sizeof(*temps));
+        dev->avg_channels = n;
+    }
+
+    next = simtemp_adaptive_next(&dev->adaptive, dev->effective_ms,
+                                 dev->avg_temp_mC, temps, thresholds, n);
+
+    dev->effective_ms = (dev->adaptive.policy == SIMTEMP_ADAPTIVE_OFF) ? dev->interval_ms : next;
+    return dev->effective_ms;
+}
+
+// Copy the last 'batch->max_samples' ticks without consuming them (SIMTEMP_IOC_GET_HISTORY)
+static long simtemp_get_history(struct simtemp_dev *dev, struct simtemp_batch *batch)
+{
+    struct simtemp_sample *snapshot;
+    unsigned int max, n;
+
+    if (batch->max_samples == 0)
+        return -EINVAL;
+
+    // Sized for the request (16 KiB worst case, too big for the stack)
+    max = min_t(u32, batch->max_samples, SIMTEMP_HISTORY_SIZE);
+    snapshot = kmalloc_array(max, sizeof(*snapshot), GFP_KERNEL);
+    if (!snapshot)
+        return -ENOMEM;
+
+    // Snapshot the newest 'n' entries, oldest first (critical section)
+    spin_lock_bh(&dev->lock);
+    n = simtemp_history_peek(&dev->history, snapshot, max);
+    spin_unlock_bh(&dev->lock);
+
+    // Copy data to user space
+    if (copy_to_user(u64_to_user_ptr(batch->samples), snapshot, n * sizeof(*snapshot))) {
+        kfree(snapshot);
+        return -EFAULT;
+    }
+
+    kfree(snapshot);
+    batch->count = n;
+    return 0;
+}
+
+// Drain up to 'batch->max_samples' records with one syscall (SIMTEMP_IOC_READ_BATCH)
+static long simtemp_read_batch(struct simtemp_dev *dev, struct file *file,
+                               struct simtemp_batch *batch)
+{
+    struct simtemp_sample samples[SIMTEMP_BUFFER_SIZE];
+    u32 n;
+
+    if (batch->max_samples == 0)
+        return -EINVAL;
+
+again:
+    // Wait for data (if blocking)
+    if (dev->ring.count == 0) {
+        if (file->f_flags & O_NONBLOCK)
+            return -EAGAIN;
+
+        if (wait_event_interruptible(dev->read_queue, dev->ring.count > 0 || dev->channels > 1))
+            return -ERESTARTSYS;
+    }
+
+    // Extract data from buffer (critical section)
+    spin_lock_bh(&dev->lock);
+
+    // Frame mode has no struct simtemp_sample records
+    if (dev->channels > 1) {
+        spin_unlock_bh(&dev->lock);
+        return -EINVAL;
+    }
+
+    n = simtemp_ring_pop(&dev->ring, samples, min_t(u32, batch->max_samples, SIMTEMP_BUFFER_SIZE));
+
+    spin_unlock_bh(&dev->lock);
+
+    // Another reader emptied the ring first: wait again, never report 0
+    if (n == 0)
+        goto again;
+
+    // Copy data to user space
+    if (copy_to_user(u64_to_user_ptr(batch->samples), samples, n * sizeof(*samples))) {
+        pr_warn("simtemp: copy_to_user failed\n");
+        spin_lock_bh(&dev->lock);
+        dev->stats.read_errors++; // Update stats
+        spin_unlock_bh(&dev->lock);
+        return -EFAULT;
+    }
+
+    batch->count = n;
+    return 0;
+}
+
+// Function for reading from the device file
+//******** Completely rewritten for binary, blocking, buffered read ******/
+static ssize_t simtemp_read(struct file *file, char __user *buf, size_t len, loff_t *offset)
+{
+    struct simtemp_dev *dev = file->private_data;
+    struct simtemp_sample sample;
+
+again:
+    // Multi-channel mode returns SoA frame batches instead
+    if (READ_ONCE(dev->channels) > 1)
+        return simtemp_read_frames(dev, file, buf, len);
+    
+    // reading a single binary record
+    if (len != sizeof(struct simtemp_sample))
+        return -EINVAL; // Invalid argument (wrong read size)
+
+    // Wait for data (if blocking)
+    if (dev->ring.count == 0) {
+        if (file->f_flags & O_NONBLOCK)
+            return -EAGAIN; // Return "try again" if non-blocking
+        
+        // wait (interruptibly) until dev->ring.count > 0 (or the mode changes)
+        if (wait_event_interruptible(dev->read_queue, dev->ring.count > 0 || dev->channels > 1))
+            return -ERESTARTSYS; // Handle signal
+    }
+
+    // Extract data from buffer (critical section)
+    spin_lock_bh(&dev->lock);
+    
+    if (dev->ring.count == 0 || dev->channels > 1) {
+        // Lost a race with another reader or woken by a channels change:
+        // start over (wait again or switch to frames), never report EOF
+        spin_unlock_bh(&dev->lock);
+        goto again;
+    }
+
+    // Copy from the ring buffer
+    simtemp_ring_pop(&dev->ring, &sample, 1);
+    
+    spin_unlock_bh(&dev->lock);
+
+    // Copy data to user space
+    if (copy_to_user(buf, &sample, sizeof(struct simtemp_sample))) {
+        pr_warn("simtemp: copy_to_user failed\n");
+        spin_lock_bh(&dev->lock);
+        dev->stats.read_errors++; // Update stats
+        spin_unlock_bh(&dev->lock);
+        return -EFAULT;
+    }
+
+    // Return bytes read, as required by read()
+    return sizeof(struct simtemp_sample);
+}
+
+// Function for polling
+static __poll_t simtemp_poll(struct file *file, poll_table *wait)
+{
+    // Get device struct from private_data
+    struct simtemp_dev *dev = file->private_data;
+    __poll_t mask = 0;
+
+    // Use the instance-specific wait queues
+    poll_wait(file, &dev->read_queue, wait);
+    poll_wait(file, &dev->threshold_queue, wait);
+
+    spin_lock_bh(&dev->lock); // Use instance-specific lock
+    
+    // Check if data is available for reading (samples or frames)
+    if (simtemp_data_ready(dev))
+        mask |= POLLIN | POLLRDNORM;
+        
+    // Check if the threshold event has occurred
+    if (dev->threshold_event) { // Use instance-specific 'threshold_event'
+        mask |= POLLPRI; // Use POLLPRI for "priority" event
+        dev->threshold_event = false; // Consume the event
+    }
+    
+    spin_unlock_bh(&dev->lock); // Use instance-specific lock
+
+    return mask;
+}
+
+// ioctl handler function
+static long simtemp_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+    struct simtemp_dev *dev = file->private_data;
+    struct simtemp_config config;
+    struct simtemp_batch batch;
+    struct simtemp_adaptive adaptive;
+    long ret = 0;
+
+    switch (cmd) {
+    case SIMTEMP_IOC_SET_CONFIG:
+        // Copy config struct from user space
+        if (copy_from_user(&config, (void __user *)arg, sizeof(config)))
+            return -EFAULT;
+
+        // Validate input
+        if (config.sampling_ms < 1 || config.sampling_ms > 10000)
+            return -EINVAL;
+
+        spin_lock_bh(&dev->lock);
+        dev->interval_ms = config.sampling_ms;
+        simtemp_set_threshold_locked(dev, config.threshold_mC);
+        if (dev->adaptive.policy == SIMTEMP_ADAPTIVE_OFF)
+            dev->effective_ms = dev->interval_ms;
+        // Restart timer with new interval
+        mod_timer(&dev->timer, jiffies + msecs_to_jiffies(dev->effective_ms));
+        spin_unlock_bh(&dev->lock);
+        
+        pr_info("simtemp: IOCTL config set (interval=%u, threshold=%d)\n",
+                config.sampling_ms, dev->threshold_mC);
+        break;
+        
+    case SIMTEMP_IOC_GET_CONFIG:
+        spin_lock_bh(&dev->lock);
+        config.sampling_ms = dev->interval_ms;
+        config.threshold_mC = dev->threshold_mC;
+        spin_unlock_bh(&dev->lock);
+
+        // Copy config struct back to user space
+        if (copy_to_user((void __user *)arg, &config, sizeof(config)))
+            return -EFAULT;
+        break;
+
+    case SIMTEMP_IOC_READ_BATCH:
+        if (copy_from_user(&batch, (void __user *)arg, sizeof(batch)))
+            return -EFAULT;
+
+        ret = simtemp_read_batch(dev, file, &batch);
+        if (ret)
+            return ret;
+
+        // Report how many records were copied
+        if (copy_to_user((void __user *)arg, &batch, sizeof(batch)))
+            return -EFAULT;
+        break;
+
+    case SIMTEMP_IOC_SET_ADAPTIVE:
+        if (copy_from_user(&adaptive, (void __user *)arg, sizeof(adaptive)))
+            return -EFAULT;
+
+        // Validate input
+        if (!simtemp_adaptive_valid(&adaptive))
+            return -EINVAL;
+
+        // All fields at once, so the generator never sees e.g. min > max
+        spin_lock_bh(&dev->lock);
+        simtemp_set_adaptive_locked(dev, &adaptive);
+        spin_unlock_bh(&dev->lock);
+        break;
+
+    case SIMTEMP_IOC_GET_ADAPTIVE:
+        spin_lock_bh(&dev->lock);
+        adaptive = dev->adaptive;
+        spin_unlock_bh(&dev->lock);
+
+        if (copy_to_user((void __user *)arg, &adaptive, sizeof(adaptive)))
+            return -EFAULT;
+        break;
+
+    case SIMTEMP_IOC_GET_HISTORY:
+        if (copy_from_user(&batch, (void __user *)arg, sizeof(batch)))
+            return -EFAULT;
+
+        ret = simtemp_get_history(dev, &batch);
+        if (ret)
+            return ret;
+
+        if (copy_to_user((void __user *)arg, &batch, sizeof(batch)))
+            return -EFAULT;
+        break;
+        
+    default:
+        ret = -EINVAL; // Unknown command
+    }
+    
+    return ret;
+}
+
+
+// Start a multicast message with the per-device attributes filled in.
+// Returns NULL if nobody listens (cheap check, no allocation) or on ENOMEM.
+static void *simtemp_nl_start(struct simtemp_dev *dev, u8 cmd, struct sk_buff **skbp)
+{
+    struct sk_buff *skb;
+    void *hdr;
+
+    if (!genl_has_listeners(&simtemp_nl_family, &init_net, SIMTEMP_NL_GRP_EVENTS))
+        return NULL;
+
+    // Called from the timer (softirq), so no sleeping allocations
+    skb = genlmsg_new(NLMSG_GOODSIZE, GFP_ATOMIC);
+    if (!skb)
+        return NULL;
+
+    hdr = genlmsg_put(skb, 0, 0, &simtemp_nl_family, 0, cmd);
+    if (!hdr)
+        goto err_free;
+
+    if (nla_put_u32(skb, SIMTEMP_NL_ATTR_DEV_ID, new_encode_dev(dev->dev_num)) ||
+        nla_put_string(skb, SIMTEMP_NL_ATTR_DEV_NAME, dev_name(dev->device)))
+        goto err_cancel;
+
+    *skbp = skb;
+    return hdr;
+
+err_cancel:
+    genlmsg_cancel(skb, hdr);
+err_free:
+    nlmsg_free(skb);
+    return NULL;
+}
+
+// Publish a threshold crossing to the "events" multicast group
+// 'channel' is < 0 in single-channel mode (attribute omitted)
+static void simtemp_nl_send_event(struct simtemp_dev *dev, const struct simtemp_sample *sample,
+                                  int threshold_mC, int channel)
+{
+    struct sk_buff *skb;
+    void *hdr;
+
+    hdr = simtemp_nl_start(dev, SIMTEMP_NL_CMD_THRESHOLD_EVENT, &skb);
+    if (!hdr)
+        return;
+
+    if (nla_put_u64_64bit(skb, SIMTEMP_NL_ATTR_TIMESTAMP_NS, sample->timestamp_ns,
+                          SIMTEMP_NL_ATTR_PAD) ||
+        nla_put_s32(skb, SIMTEMP_NL_ATTR_TEMP_MC, sample->temp_mC) ||
+        nla_put_s32(skb, SIMTEMP_NL_ATTR_THRESHOLD_MC, threshold_mC) ||
+        (channel >= 0 && nla_put_u32(skb, SIMTEMP_NL_ATTR_CHANNEL, channel))) {
+        genlmsg_cancel(skb, hdr);
+        nlmsg_free(skb);
+        return;
+    }
+
+    genlmsg_end(skb, hdr);
+    genlmsg_multicast(&simtemp_nl_family, skb, 0, SIMTEMP_NL_GRP_EVENTS, GFP_ATOMIC);
+}
+
+// Publish one aggregate record (window already snapshotted by the caller)
+static void simtemp_nl_send_aggregate(struct simtemp_dev *dev, const struct simtemp_aggregate *agg)
+{
+    struct sk_buff *skb;
+    void *hdr;
+
+    hdr = simtemp_nl_start(dev, SIMTEMP_NL_CMD_AGGREGATE, &skb);
+    if (!hdr)
+        return;
+
+    if (nla_put_u64_64bit(skb, SIMTEMP_NL_ATTR_FIRST_TS_NS, agg->first_ts_ns,
+                          SIMTEMP_NL_ATTR_PAD) ||
+        nla_put_u64_64bit(skb, SIMTEMP_NL_ATTR_TIMESTAMP_NS, agg->last_ts_ns,
+                          SIMTEMP_NL_ATTR_PAD) ||
+        nla_put_u32(skb, SIMTEMP_NL_ATTR_COUNT, agg->count) ||
+        nla_put_s32(skb, SIMTEMP_NL_ATTR_MIN_MC, agg->min_mC) ||
+        nla_put_s32(skb, SIMTEMP_NL_ATTR_MAX_MC, agg->max_mC) ||
+        nla_put_s32(skb, SIMTEMP_NL_ATTR_MEAN_MC, (s32)div_s64(agg->sum_mC, agg->count)) ||
+        nla_put_u32(skb, SIMTEMP_NL_ATTR_ALERTS, agg->alerts)) {
+        genlmsg_cancel(skb, hdr);
+        nlmsg_free(skb);
+        return;
+    }
+
+    genlmsg_end(skb, hdr);
+    genlmsg_multicast(&simtemp_nl_family, skb, 0, SIMTEMP_NL_GRP_EVENTS, GFP_ATOMIC);
+}
+
+// Generate one multi-channel frame into the frame ring. Caller holds dev->lock.
+// Returns the mask of channels that newly crossed their threshold; 'temps'
+// and 'thresholds' receive a copy for the netlink notifications.
+static u32 simtemp_generate_frame(struct simtemp_dev *dev, u64 timestamp_ns,
+                                  s32 *temps, s32 *thresholds)
+{
+    unsigned int n = dev->channels;
+    unsigned int ch;
+    u32 mask;
+    u32 rising;
+
+    // Per-channel generator (same ranges as single-channel mode)
+    for (ch = 0; ch < n; ch++)
+        temps[ch] = simtemp_generate_temp(dev->mode, dev->stats.samples_generated, ch);
+
+    // Threshold evaluation (vectorizable, see simtemp_core.c)
+    memcpy(thresholds, dev->channel_threshold_mC, n * sizeof(*thresholds));
+    mask = simtemp_threshold_mask(temps, thresholds, n);
+
+    // Edge detection, same semantics as the single-channel threshold_flag
+    rising = mask & ~dev->channel_alert_mask;
+    dev->channel_alert_mask = mask;
+    dev->threshold_flag = mask != 0;
+    if (rising) {
+        dev->threshold_event = true;
+        dev->stats.alerts_triggered += hweight32(rising);
+        wake_up_interruptible(&dev->threshold_queue);
+    }
+
+    // sysfs temperature reports this frame whether or not the ring takes it
+    memcpy(dev->last_temp_mC, temps, n * sizeof(*temps));
+
+    // History keeps channel 0, so GET_HISTORY works in both modes
+    {
+        struct simtemp_sample ch0 = {
+            .timestamp_ns = timestamp_ns,
+            .temp_mC = temps[0],
+            .flags = SIMTEMP_FLAG_NEW_SAMPLE |
+                     ((rising & 1) ? SIMTEMP_FLAG_THRESHOLD_CROSSED : 0),
+        };
+        simtemp_history_push(&dev->history, &ch0);
+    }
+
+    // Store the frame if space available
+    if (simtemp_frame_ring_push(&dev->frames, timestamp_ns, mask, temps, n)) {
+        dev->stats.samples_generated += n; // Update stats
+
+        // Wake up read() / poll()
+        wake_up_interruptible(&dev->read_queue);
+    }
+
+    return rising;
+}
+
+// Add one sample to the netlink aggregate window. Returns true and copies
+// the finished window to 'out' once nl_aggregate_samples are collected.
+// Caller holds dev->lock.
+static bool simtemp_aggregate_add_locked(struct simtemp_dev *dev, u64 timestamp_ns, int temp_mC,
+                                         bool crossed, struct simtemp_aggregate *out)
+{
+    struct simtemp_aggregate *a = &dev->agg;
+
+    if (!dev->nl_aggregate_samples)
+        return false;
+
+    if (a->count == 0) {
+        a->first_ts_ns = timestamp_ns;
+        a->min_mC = temp_mC;
+        a->max_mC = temp_mC;
+    }
+    a->min_mC = min(a->min_mC, temp_mC);
+    a->max_mC = max(a->max_mC, temp_mC);
+    a->last_ts_ns = timestamp_ns;
+    a->sum_mC += temp_mC;
+    a->count++;
+    if (crossed)
+        a->alerts++;
+
+    if (a->count < dev->nl_aggregate_samples)
+        return false;
+
+    *out = *a;
+    memset(a, 0, sizeof(*a));
+    return true;
+}
+
+// Timer callback function (for periodic readings)
+static void simtemp_timer_callback(struct timer_list *t)
+{
+    // Get dev struct from the timer
+    struct simtemp_dev *dev = from_timer(dev, t, timer);
+    
+    // Define variables for the new binary sample
+    struct simtemp_sample new_sample;
+    int new_temp_mC;
+    u32 flags = 0;
+
+    // Netlink work is done after dropping the lock
+    struct simtemp_aggregate agg = {};
+    bool nl_event = false;
+    bool nl_aggregate = false;
+    int threshold_mC;
+
+    // Multi-channel frame scratch (copies for netlink after unlock)
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+    u32 rising;
+
+    // Period of the next tick (adaptive or fixed)
+    unsigned int next_ms;
+
+    // Simulate temperature reading based on mode
+    spin_lock(&dev->lock); //Use spin_lock (not bh) in timer context
+    dev->stats.ticks++;
+
+    // Multi-channel mode: one frame of N channels with a shared timestamp
+    if (dev->channels > 1) {
+        new_sample.timestamp_ns = ktime_get_ns();
+        rising = simtemp_generate_frame(dev, new_sample.timestamp_ns, temps, thresholds);
+        // Aggregates follow channel 0, like the history ring
+        nl_aggregate = simtemp_aggregate_add_locked(dev, new_sample.timestamp_ns, temps[0],
+                                                    rising & 1, &agg);
+        next_ms = simtemp_adaptive_update_locked(dev, temps, thresholds, dev->channels);
+        spin_unlock(&dev->lock);
+
+        // One netlink event per channel that crossed (outside the lock)
+        while (rising) {
+            unsigned int ch = __ffs(rising);
+
+            new_sample.temp_mC = temps[ch];
+            new_sample.flags = SIMTEMP_FLAG_NEW_SAMPLE | SIMTEMP_FLAG_THRESHOLD_CROSSED;
+            simtemp_nl_send_event(dev, &new_sample, thresholds[ch], ch);
+            rising &= rising - 1;
+        }
+        if (nl_aggregate)
+            simtemp_nl_send_aggregate(dev, &agg);
+        goto reschedule;
+    }
+    
+    new_temp_mC = simtemp_generate_temp(dev->mode, dev->stats.samples_generated, 0);
+    
+    // Check threshold (rising edge triggers the event)
+    if (simtemp_threshold_update(&dev->threshold_flag, new_temp_mC, dev->threshold_mC)) {
+        dev->threshold_event = true;
+        flags |= SIMTEMP_FLAG_THRESHOLD_CROSSED; // Set binary flag
+        dev->stats.alerts_triggered++;          // Update stats
+        nl_event = true;
+        
+        pr_info("simtemp: TEMP FLAG ACTIVATED (temp=%d, thr=%d)\n",
+                new_temp_mC, dev->threshold_mC);
+        
+        // Wake up poll()
+        wake_up_interruptible(&dev->threshold_queue);
+    }
+
+    // Create and buffer the binary sample
+    new_sample.timestamp_ns = ktime_get_ns();
+    new_sample.temp_mC = new_temp_mC;
+    new_sample.flags = flags | SIMTEMP_FLAG_NEW_SAMPLE;
+
+    // History gets every tick, even if the read() ring is full
+    simtemp_history_push(&dev->history, &new_sample);
+
+    // Accumulate the netlink aggregate window (independent of ring space)
+    nl_aggregate = simtemp_aggregate_add_locked(dev, new_sample.timestamp_ns, new_temp_mC,
+                                                flags & SIMTEMP_FLAG_THRESHOLD_CROSSED, &agg);
+    threshold_mC = dev->threshold_mC;
+
+    // Adaptive sampling looks at this tick to choose the next period
+    next_ms = simtemp_adaptive_update_locked(dev, &new_temp_mC, &threshold_mC, 1);
+
+    // Add to ring buffer if space available
+    if (simtemp_ring_push(&dev->ring, &new_sample)) {
+        dev->stats.samples_generated++; // Update stats
+        
+        // Wake up read() / poll()
+        wake_up_interruptible(&dev->read_queue);
+    } else {
+        // pr_warn("simtemp: buffer overflow\n"); // NEW: Optional warning
+    }
+
+    spin_unlock(&dev->lock);
+
+    // Multicast to netlink subscribers (outside the lock)
+    if (nl_event)
+        simtemp_nl_send_event(dev, &new_sample, threshold_mC, -1);
+    if (nl_aggregate)
+        simtemp_nl_send_aggregate(dev, &agg);
+
+reschedule:
+    // Reschedule timer
+    mod_timer(&dev->timer, jiffies + msecs_to_jiffies(next_ms));
+}
+
+
+// --- Sysfs Handlers ---
+// MODIFIED: All handlers now use 'dev_get_drvdata(dev)' to get the
+// instance-specific 'simdev' pointer.
+
+// Handler for /sys/class/simtemp/simtemp/sampling_ms (show)
+static ssize_t sampling_ms_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    // Get instance struct from device
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    return sprintf(buf, "%u\n", simdev->interval_ms);
+}
+
+// Handler for /sys/class/simtemp/simtemp/sampling_ms (store)
+static ssize_t sampling_ms_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    unsigned long val;
+    int ret = kstrtoul(buf, 10, &val);
+    if (ret) return ret;
+    
+    // Validate
+    if (val < 1 || val > 10000) return -EINVAL; // 1ms to 10s
+
+    spin_lock_bh(&simdev->lock);
+    simdev->interval_ms = val;
+    if (simdev->adaptive.policy == SIMTEMP_ADAPTIVE_OFF)
+        simdev->effective_ms = val;
+    // Reschedule timer with new interval
+    mod_timer(&simdev->timer, jiffies + msecs_to_jiffies(simdev->effective_ms)); 
+    spin_unlock_bh(&simdev->lock); 
+
+    pr_info("simtemp: sampling interval updated to %lu ms\n", val);
+    return count;
+}
+
+// Handler for /sys/class/simtemp/simtemp/temperature (show)
+static ssize_t temperature_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev); 
+    struct simtemp_sample last;
+    int temp = 2500; 
+    
+    spin_lock_bh(&simdev->lock); 
+    // Multi-channel mode: newest generated frame, one value per channel
+    // (independent of the frame ring, which stops moving when full or drained)
+    if (simdev->channels > 1) {
+        unsigned int ch;
+        ssize_t len = 0;
+
+        for (ch = 0; ch < simdev->channels; ch++)
+            len += sysfs_emit_at(buf, len, "%d%c", simdev->last_temp_mC[ch],
+                                 ch + 1 < simdev->channels ? ' ' : '\n');
+        spin_unlock_bh(&simdev->lock);
+        return len;
+    }
+    // Read last temperature from the history (still valid after read() drained the ring)
+    if (simtemp_history_peek(&simdev->history, &last, 1))
+        temp = last.temp_mC;
+    spin_unlock_bh(&simdev->lock); 
+    
+    return sprintf(buf, "%d\n", temp);
+}
+
+// Handler for /sys/class/simtemp/simtemp/threshold_flag (show)
+static ssize_t threshold_flag_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev); 
+    return sprintf(buf, "%d\n", simdev->threshold_flag); 
+}
+
+// MODIFIED: Renamed from threshold_lower_show
+static ssize_t threshold_mC_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev); 
+    return sprintf(buf, "%d\n", simdev->threshold_mC); 
+}
+
+// MODIFIED: enamed from threshold_lower_store
+static ssize_t threshold_mC_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev); 
+    int val; 
+    
+    if (kstrtoint(buf, 10, &val)) 
+        return -EINVAL;
+
+    spin_lock_bh(&simdev->lock); 
+    simtemp_set_threshold_locked(simdev, val); // Also resets per-channel thresholds
+    spin_unlock_bh(&simdev->lock); 
+    return count;
+}
+
+// Handler for /sys/class/simtemp/simtemp/mode (show)
+static ssize_t mode_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    switch (simdev->mode) {
+        case SIMTEMP_MODE_NORMAL: return sprintf(buf, "normal\n");
+        case SIMTEMP_MODE_NOISY:  return sprintf(buf, "noisy\n");
+        case SIMTEMP_MODE_RAMP:   return sprintf(buf, "ramp\n");
+        default:                  return sprintf(buf, "unknown\n");
+    }
+}
+
+// Handler for /sys/class/simtemp/simtemp/mode (store)
+static ssize_t mode_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    
+    spin_lock_bh(&simdev->lock);
+    if (strncmp(buf, "normal", 6) == 0){
+        simdev->mode = SIMTEMP_MODE_NORMAL;
+        pr_info("TEMP MODE HAS CHANGED TO normal MODE");
+    
+    }
+    else if (strncmp(buf, "noisy", 5) == 0){
+        simdev->mode = SIMTEMP_MODE_NOISY;
+        pr_info("TEMP MODE HAS CHANGED TO noisy MODE");
+    }
+    else if (strncmp(buf, "ramp", 4) == 0){
+        simdev->mode = SIMTEMP_MODE_RAMP;
+        pr_info("TEMP MODE HAS CHANGED TO ramp MODE");
+    }
+    else {
+        spin_unlock_bh(&simdev->lock);
+        return -EINVAL; // Invalid mode
+    }
+    spin_unlock_bh(&simdev->lock);
+    return count;
+}
+
+// Handler for /sys/class/simtemp/simtemp/stats (show)
+static ssize_t stats_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    u64 samples, alerts, errors, ticks, elapsed_ms;
+    unsigned int effective_ms;
+    
+    // Read stats atomically
+    spin_lock_bh(&simdev->lock);
+    samples = simdev->stats.samples_generated;
+    alerts = simdev->stats.alerts_triggered;
+    errors = simdev->stats.read_errors;
+    ticks = simdev->stats.ticks;
+    effective_ms = simdev->effective_ms;
+    spin_unlock_bh(&simdev->lock);
+
+    // Average tick rate since probe, in milli-Hz (compare with 1000000 / effective_ms)
+    elapsed_ms = max_t(u64, 1, div_u64(ktime_get_ns() - simdev->start_ns, NSEC_PER_MSEC));
+    
+    return sprintf(buf, "samples_generated: %llu\nalerts_triggered: %llu\nread_errors: %llu\n"
+                   "ticks: %llu\neffective_interval_ms: %u\neffective_rate_mHz: %u\n"
+                   "average_rate_mHz: %llu\n",
+                   samples, alerts, errors, ticks, effective_ms, 1000000U / effective_ms,
+                   div64_u64(ticks * 1000000ULL, elapsed_ms));
+}
+
+// Handler for /sys/class/simtemp/simtemp/nl_aggregate_samples (show)
+static ssize_t nl_aggregate_samples_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    return sprintf(buf, "%u\n", simdev->nl_aggregate_samples);
+}
+
+// Handler for /sys/class/simtemp/simtemp/nl_aggregate_samples (store)
+static ssize_t nl_aggregate_samples_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    unsigned int val;
+
+    if (kstrtouint(buf, 10, &val))
+        return -EINVAL;
+
+    // Validate (0 disables aggregates)
+    if (val > 100000)
+        return -EINVAL;
+
+    spin_lock_bh(&simdev->lock);
+    simdev->nl_aggregate_samples = val;
+    memset(&simdev->agg, 0, sizeof(simdev->agg)); // Start a fresh window
+    spin_unlock_bh(&simdev->lock);
+    return count;
+}
+
+// Handler for /sys/class/simtemp/simtemp/channels (show)
+static ssize_t channels_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    return sprintf(buf, "%u\n", simdev->channels);
+}
+
+// Handler for /sys/class/simtemp/simtemp/channels (store)
+// 1 = classic struct simtemp_sample records, 2..32 = SoA frames
+static ssize_t channels_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    unsigned int val;
+
+    if (kstrtouint(buf, 10, &val))
+        return -EINVAL;
+
+    // Validate
+    if (val < 1 || val > SIMTEMP_MAX_CHANNELS)
+        return -EINVAL;
+
+    spin_lock_bh(&simdev->lock);
+    simdev->channels = val;
+    // Frames of the old width and samples from before the switch are stale now
+    simdev->frames.head = 0;
+    simdev->frames.tail = 0;
+    simdev->frames.count = 0;
+    simdev->ring.head = 0;
+    simdev->ring.tail = 0;
+    simdev->ring.count = 0;
+    simdev->channel_alert_mask = 0;
+    spin_unlock_bh(&simdev->lock);
+
+    // Let blocked readers re-evaluate the read layout
+    wake_up_interruptible(&simdev->read_queue);
+
+    pr_info("simtemp: channels updated to %u\n", val);
+    return count;
+}
+
+// Handler for /sys/class/simtemp/simtemp/channel_thresholds_mC (show)
+static ssize_t channel_thresholds_mC_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+    unsigned int n, ch;
+    ssize_t len = 0;
+
+    spin_lock_bh(&simdev->lock);
+    n = simdev->channels;
+    memcpy(thresholds, simdev->channel_threshold_mC, sizeof(thresholds));
+    spin_unlock_bh(&simdev->lock);
+
+    for (ch = 0; ch < n; ch++)
+        len += sysfs_emit_at(buf, len, "%d%c", thresholds[ch], ch + 1 < n ? ' ' : '\n');
+    return len;
+}
+
+// Handler for /sys/class/simtemp/simtemp/channel_thresholds_mC (store)
+// Space-separated list, channel 0 first; channels not listed keep their value
+static ssize_t channel_thresholds_mC_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+    unsigned int n = 0;
+    char *copy, *cur, *tok;
+    int ret = 0;
+
+    copy = kstrndup(buf, count, GFP_KERNEL);
+    if (!copy)
+        return -ENOMEM;
+
+    // Parse everything first, so a bad list changes nothing
+    cur = strim(copy);
+    while ((tok = strsep(&cur, " \t,")) != NULL) {
+        if (*tok == '\0')
+            continue;
+        if (n == SIMTEMP_MAX_CHANNELS || kstrtoint(tok, 10, &thresholds[n])) {
+            ret = -EINVAL;
+            break;
+        }
+        n++;
+    }
+    kfree(copy);
+    if (ret)
+        return ret;
+    if (n == 0)
+        return -EINVAL;
+
+    spin_lock_bh(&simdev->lock);
+    memcpy(simdev->channel_threshold_mC, thresholds, n * sizeof(*thresholds));
+    spin_unlock_bh(&simdev->lock);
+    return count;
+}
+
+// Handler for /sys/class/simtemp/simtemp/adaptive (show): off | jump | halve
+static ssize_t adaptive_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    switch (simdev->adaptive.policy) {
+        case SIMTEMP_ADAPTIVE_OFF:   return sprintf(buf, "off\n");
+        case SIMTEMP_ADAPTIVE_JUMP:  return sprintf(buf, "jump\n");
+        case SIMTEMP_ADAPTIVE_HALVE: return sprintf(buf, "halve\n");
+        default:                     return sprintf(buf, "unknown\n");
+    }
+}
+
+// Handler for /sys/class/simtemp/simtemp/adaptive (store)
+static ssize_t adaptive_store(struct device *dev, struct device_attribute *attr, const char *buf, size_t count)
+{
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);
+    struct simtemp_adaptive cfg;
+
+    spin_lock_bh(&simdev->lock);
+    cfg = simdev->adaptive;
+    if (sysfs_streq(buf, "off"))
+        cfg.policy = SIMTEMP_ADAPTIVE_OFF;
+    else if (sysfs_streq(buf, "jump"))
+        cfg.policy = SIMTEMP_ADAPTIVE_JUMP;
+    else if (sysfs_streq(buf, "halve"))
+        cfg.policy = SIMTEMP_ADAPTIVE_HALVE;
+    else {
+        spin_unlock_bh(&simdev->lock);
+        return -EINVAL; // Invalid policy
+    }
+    simtemp_set_adaptive_locked(simdev, &cfg);
+    spin_unlock_bh(&simdev->lock);
+
+    pr_info("simtemp: adaptive sampling policy set to %u\n", cfg.policy);
+    return count;
+}
+
+// Show/store for the numeric adaptive fields: each store validates the
+// whole resulting config (e.g. min_ms <= max_ms) before applying it
+#define SIMTEMP_ADAPTIVE_ATTR(name, field, fmt, parse)                                  \
+static ssize_t name##_show(struct device *dev, struct device_attribute *attr, char *buf) \
+{                                                                                       \
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);                                  \
+    return sprintf(buf, fmt "\n", simdev->adaptive.field);                              \
+}                                                                                       \
+static ssize_t name##_store(struct device *dev, struct device_attribute *attr,          \
+                            const char *buf, size_t count)                              \
+{                                                                                       \
+    struct simtemp_dev *simdev = dev_get_drvdata(dev);                                  \
+    struct simtemp_adaptive cfg;                                                        \
+    typeof(cfg.field) val;                                                              \
+                                                                                        \
+    if (parse(buf, 10, &val))                                                           \
+        return -EINVAL;                                                                 \
+                                                                                        \
+    spin_lock_bh(&simdev->lock);                                                        \
+    cfg = simdev->adaptive;                                                             \
+    cfg.field = val;                                                                    \
+    if (!simtemp_adaptive_valid(&cfg)) {                                                \
+        spin_unlock_bh(&simdev->lock);                                                  \
+        return -EINVAL;                                                                 \
+    }                                                                                   \
+    simtemp_set_adaptive_locked(simdev, &cfg);                                          \
+    spin_unlock_bh(&simdev->lock);                                                      \
+    return count;                                                                       \
+}
+
+SIMTEMP_ADAPTIVE_ATTR(adaptive_min_ms, min_ms, "%u", kstrtouint)
+SIMTEMP_ADAPTIVE_ATTR(adaptive_max_ms, max_ms, "%u", kstrtouint)
+SIMTEMP_ADAPTIVE_ATTR(adaptive_step_ms, step_ms, "%u", kstrtouint)
+SIMTEMP_ADAPTIVE_ATTR(adaptive_band_mC, band_mC, "%d", kstrtoint)
+SIMTEMP_ADAPTIVE_ATTR(adaptive_slope_mC, slope_mC, "%d", kstrtoint)
+
+
+// This is now the 'probe' function for the platform driver.
+// It contains all the setup logic from your original 'simtemp_init'.
+static int simtemp_probe(struct platform_device *pdev)
+{
+    int ret;
+    struct simtemp_dev *simdev; // Local variable, not global
+    struct device *dev = &pdev->dev; // Device from platform_device
+
+    pr_info("simtemp: probe function called!\n");
+
+    // Allocate memory for our device struct.
+    // 'devm_kzalloc' is managed by the device, automatically freed on remove.
+    simdev = devm_kzalloc(dev, sizeof(*simdev), GFP_KERNEL);
+    if (!simdev)
+        return -ENOMEM;
+    
+    // Link the platform_device to our simdev struct
+    platform_set_drvdata(pdev, simdev);
+
+    // Initialize locks and wait queues
+    spin_lock_init(&simdev->lock);
+    init_waitqueue_head(&simdev->read_queue);
+    init_waitqueue_head(&simdev->threshold_queue);
+    simdev->ring.head = 0;
+    simdev->ring.tail = 0;
+    simdev->ring.count = 0;
+    simdev->history.head = 0;
+    simdev->history.count = 0;
+    simdev->channels = 1; // Single-channel records by default
+    simdev->start_ns = ktime_get_ns();
+
+    // Adaptive sampling defaults (disabled until a policy is chosen)
+    simdev->adaptive.policy = SIMTEMP_ADAPTIVE_OFF;
+    simdev->adaptive.min_ms = 10;
+    simdev->adaptive.max_ms = 1000;
+    simdev->adaptive.step_ms = 50;
+    simdev->adaptive.band_mC = 2000;
+    simdev->adaptive.slope_mC = 1000;
+
+    #if TEST
+        pr_info("simtemp: Using default config for local test\n");
+        simdev->interval_ms = 1000;
+        simtemp_set_threshold_locked(simdev, 27000);
+        simdev->mode = SIMTEMP_MODE_NORMAL;
+
+    #else
+        u32 val; // For reading DT properties
+        // Always use defaults for local testing (no DT)
+        pr_info("simtemp: Loading configuration from Device Tree\n");
+        ret = of_property_read_u32(dev->of_node, "sampling-ms", &val);
+        simdev->interval_ms = (ret == 0) ? val : 1000; // Default 1000ms
+
+        ret = of_property_read_u32(dev->of_node, "threshold-mC", &val);
+        simtemp_set_threshold_locked(simdev, (ret == 0) ? (int)val : 27000); // Default 27C
+
+        simdev->mode = SIMTEMP_MODE_NORMAL; // Default mode
+        
+        pr_info("simtemp: DT config loaded (interval=%u ms, threshold=%d mC)\n",
+                simdev->interval_ms, simdev->threshold_mC);    
+    #endif
+
+    simdev->effective_ms = simdev->interval_ms;
+
+    ret = alloc_chrdev_region(&simdev->dev_num, 0, 1, DEVICE_NAME);
+    if (ret < 0) {
+        pr_err("simtemp: failed to alloc chrdev region\n");
+        return ret;
+    }
+
+    pr_info("simtemp: device number allocated (major=%d, minor=%d)\n",
+            MAJOR(simdev->dev_num), MINOR(simdev->dev_num));
+
+    // init chardev
+    cdev_init(&simdev->cdev, &simtemp_fops);
+    simdev->cdev.owner = THIS_MODULE;
+    ret = cdev_add(&simdev->cdev, simdev->dev_num, 1);
+    if (ret < 0) {
+        pr_err("simtemp: failed to add cdev\n");
+        goto err_unregister_chrdev; // Error handling
+    }
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 4, 0)  
+    simdev->class = class_create(CLASS_NAME);
+#else  
+    simdev->class = class_create(THIS_MODULE, CLASS_NAME);
+#endif
+    if (IS_ERR(simdev->class)) {
+        pr_err("simtemp: failed to create class\n");
+        ret = PTR_ERR(simdev->class);
+        goto err_cdev_del; 
+    }
+    
+    simdev->class->devnode = simtemp_devnode;
+
+    // Set dev (&pdev->dev) as parent
+    // Pass simdev as driver data for sysfs handlers
+    simdev->device = device_create(simdev->class, dev /*parent*/, simdev->dev_num,
+                                   simdev /*drvdata*/, DEVICE_NAME);
+    if (IS_ERR(simdev->device)) {
+        pr_err("simtemp: failed to create device node\n");
+        ret = PTR_ERR(simdev->device);
+        goto err_class_destroy;
+    }
+
+    ret = device_create_file(simdev->device, &dev_attr_sampling_ms);
+    if (ret) pr_err("simtemp: failed to create sysfs sampling_ms\n");
+    
+    ret = device_create_file(simdev->device, &dev_attr_temperature);
+    if (ret) pr_err("simtemp: failed to create sysfs temperature\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_threshold_flag);
+    if (ret) pr_err("simtemp: failed to create sysfs threshold_flag\n");
+    
+    ret = device_create_file(simdev->device, &dev_attr_threshold_mC);
+    if (ret) pr_err("simtemp: failed to create sysfs threshold_mC\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_mode);
+    if (ret) pr_err("simtemp: failed to create sysfs mode\n");
+    
+    ret = device_create_file(simdev->device, &dev_attr_stats);
+    if (ret) pr_err("simtemp: failed to create sysfs stats\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_nl_aggregate_samples);
+    if (ret) pr_err("simtemp: failed to create sysfs nl_aggregate_samples\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_channels);
+    if (ret) pr_err("simtemp: failed to create sysfs channels\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_channel_thresholds_mC);
+    if (ret) pr_err("simtemp: failed to create sysfs channel_thresholds_mC\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_adaptive);
+    if (ret) pr_err("simtemp: failed to create sysfs adaptive\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_adaptive_min_ms);
+    if (ret) pr_err("simtemp: failed to create sysfs adaptive_min_ms\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_adaptive_max_ms);
+    if (ret) pr_err("simtemp: failed to create sysfs adaptive_max_ms\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_adaptive_step_ms);
+    if (ret) pr_err("simtemp: failed to create sysfs adaptive_step_ms\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_adaptive_band_mC);
+    if (ret) pr_err("simtemp: failed to create sysfs adaptive_band_mC\n");
+
+    ret = device_create_file(simdev->device, &dev_attr_adaptive_slope_mC);
+    if (ret) pr_err("simtemp: failed to create sysfs adaptive_slope_mC\n");
+
+    timer_setup(&simdev->timer, simtemp_timer_callback, 0);
+    mod_timer(&simdev->timer, jiffies + msecs_to_jiffies(simdev->effective_ms));
+
+    pr_info("simtemp: module loaded and probe successful\n");
+    return 0; // Success
+
+// handling goto labels for probe PENDING CHECK IF ALLOWED ON KERNEL DEV
+err_class_destroy:
+    class_destroy(simdev->class);
+err_cdev_del:
+    cdev_del(&simdev->cdev);
+err_unregister_chrdev:
+    unregister_chrdev_region(simdev->dev_num, 1);
+    pr_err("simtemp: probe failed!\n");
+    return ret;
+}
+
+
+// remove function for the platform driver.
+static void simtemp_remove(struct platform_device *pdev)
+{
+    // Get simdev struct from the platform_device
+    struct simtemp_dev *simdev = platform_get_drvdata(pdev);
+
+    pr_info("simtemp: remove function called\n");
+
+    del_timer_sync(&simdev->timer);
+    
+
+    wake_up_interruptible_all(&simdev->read_queue);
+    wake_up_interruptible_all(&simdev->threshold_queue);
+
+    device_remove_file(simdev->device, &dev_attr_sampling_ms);
+    device_remove_file(simdev->device, &dev_attr_temperature);
+    device_remove_file(simdev->device, &dev_attr_threshold_flag);
+    device_remove_file(simdev->device, &dev_attr_threshold_mC);
+    device_remove_file(simdev->device, &dev_attr_mode);    
+    device_remove_file(simdev->device, &dev_attr_stats);   
+    device_remove_file(simdev->device, &dev_attr_nl_aggregate_samples);
+    device_remove_file(simdev->device, &dev_attr_channels);
+    device_remove_file(simdev->device, &dev_attr_channel_thresholds_mC);
+    device_remove_file(simdev->device, &dev_attr_adaptive);
+    device_remove_file(simdev->device, &dev_attr_adaptive_min_ms);
+    device_remove_file(simdev->device, &dev_attr_adaptive_max_ms);
+    device_remove_file(simdev->device, &dev_attr_adaptive_step_ms);
+    device_remove_file(simdev->device, &dev_attr_adaptive_band_mC);
+    device_remove_file(simdev->device, &dev_attr_adaptive_slope_mC);
+
+    device_destroy(simdev->class, simdev->dev_num);
+    
+    class_destroy(simdev->class);
+
+    cdev_del(&simdev->cdev);
+    
+    unregister_chrdev_region(simdev->dev_num, 1);
+
+    pr_info("simtemp: module unloaded\n");
+}
+
+
+#if TEST
+    // --- TEST MODE ---
+    static int __init simtemp_driver_init(void)
+    {
+        int ret;
+
+        ret = genl_register_family(&simtemp_nl_family);
+        if (ret) {
+            pr_err("simtemp: failed to register netlink family\n");
+            return ret;
+        }
+
+        pr_info("simtemp: Registering platform driver (TEST MODE)\n");
+        
+        ret = platform_driver_register(&simtemp_platform_driver);
+        if (ret) {
+            pr_err("simtemp: failed to register platform driver\n");
+            genl_unregister_family(&simtemp_nl_family);
+            return ret;
+        }
+        
+        pr_info("simtemp: Registering local test device\n");
+        simtemp_pdev_test = platform_device_register_simple(DEVICE_NAME, -1, NULL, 0);
+        
+        if (IS_ERR(simtemp_pdev_test)) {
+            pr_err("simtemp: failed to register test device\n");
+            platform_driver_unregister(&simtemp_platform_driver);
+            genl_unregister_family(&simtemp_nl_family);
+            return PTR_ERR(simtemp_pdev_test);
+        }
+        return 0; // Success
+    }
+
+    static void __exit simtemp_driver_exit(void)
+    {
+        pr_info("simtemp: Unregistering driver and test device (TEST MODE)\n");
+        platform_device_unregister(simtemp_pdev_test);
+        platform_driver_unregister(&simtemp_platform_driver);
+        genl_unregister_family(&simtemp_nl_family);
+    }
+
+#else
+    // --- MODO PRODUCCIÓN / DT ---
+    static int __init simtemp_driver_init(void)
+    {
+        int ret;
+
+        ret = genl_register_family(&simtemp_nl_family);
+        if (ret) {
+            pr_err("simtemp: failed to register netlink family\n");
+            return ret;
+        }
+
+        pr_info("simtemp: Registering platform driver (DT-MODE)\n");
+        // Solo registrar el driver. El DT proveerá el dispositivo.
+        ret = platform_driver_register(&simtemp_platform_driver);
+        if (ret)
+            genl_unregister_family(&simtemp_nl_family);
+        return ret;
+    }
+
+    static void __exit simtemp_driver_exit(void)
+    {
+        pr_info("simtemp: Unregistering platform driver (DT-MODE)\n");
+        platform_driver_unregister(&simtemp_platform_driver);
+        genl_unregister_family(&simtemp_nl_family);
+    }
+#endif
+
+
+// KUnit suite (built in with CONFIG_NXP_SIMTEMP_KUNIT_TEST, see Kconfig).
+// Included rather than linked so the tests reach the static timer callback
+// and sysfs handlers.
+#if IS_ENABLED(CONFIG_NXP_SIMTEMP_KUNIT_TEST)
+#include "simtemp_kunit.c"
+#endif
+
+// Register init and exit functions
+module_init(simtemp_driver_init);
+module_exit(simtemp_driver_exit); 
+
+// Module information
+MODULE_LICENSE("GPL");
+MODULE_AUTHOR("Cesar Ochoa");
+MODULE_DESCRIPTION("Simulated temperature sensor (Platform Driver) for NXP Challenge");
\ No newline at end of file
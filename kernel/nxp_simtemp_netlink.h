@@ -0,0 +1,46 @@
+#ifndef NXP_SIMTEMP_NETLINK_H
+#define NXP_SIMTEMP_NETLINK_H
+
+/*
+ * Generic netlink API for the simtemp driver.
+ * Shared with user space (same rule as nxp_simtemp_ioctl.h: keep it uapi-only).
+ *
+ * The driver registers one family with one multicast group. Subscribers
+ * resolve the family with CTRL_CMD_GETFAMILY and join the group; every
+ * message carries the device id/name so one socket can follow N devices.
+ */
+
+#define SIMTEMP_NL_FAMILY_NAME  "simtemp"
+#define SIMTEMP_NL_VERSION      1
+#define SIMTEMP_NL_MCGRP_NAME   "events"
+
+// Commands (only sent by the kernel, as multicast notifications)
+enum simtemp_nl_cmd {
+    SIMTEMP_NL_CMD_UNSPEC,
+    SIMTEMP_NL_CMD_THRESHOLD_EVENT, // a sample crossed threshold_mC
+    SIMTEMP_NL_CMD_AGGREGATE,       // periodic min/max/mean record
+    __SIMTEMP_NL_CMD_MAX,
+};
+#define SIMTEMP_NL_CMD_MAX (__SIMTEMP_NL_CMD_MAX - 1)
+
+// Attributes
+enum simtemp_nl_attr {
+    SIMTEMP_NL_ATTR_UNSPEC,
+    SIMTEMP_NL_ATTR_PAD,
+    SIMTEMP_NL_ATTR_DEV_ID,       // u32, new_encode_dev() of the char device
+    SIMTEMP_NL_ATTR_DEV_NAME,     // string, e.g. "simtemp"
+    SIMTEMP_NL_ATTR_TIMESTAMP_NS, // u64, ktime_get_ns() (last sample for aggregates)
+    SIMTEMP_NL_ATTR_TEMP_MC,      // s32, sample that crossed the threshold
+    SIMTEMP_NL_ATTR_THRESHOLD_MC, // s32, threshold in force at that moment
+    SIMTEMP_NL_ATTR_FIRST_TS_NS,  // u64, first sample of the aggregate window
+    SIMTEMP_NL_ATTR_COUNT,        // u32, samples in the aggregate window
+    SIMTEMP_NL_ATTR_MIN_MC,       // s32
+    SIMTEMP_NL_ATTR_MAX_MC,       // s32
+    SIMTEMP_NL_ATTR_MEAN_MC,      // s32
+    SIMTEMP_NL_ATTR_ALERTS,       // u32, threshold events inside the window
+    SIMTEMP_NL_ATTR_CHANNEL,      // u32, channel index (multi-channel mode only)
+    __SIMTEMP_NL_ATTR_MAX,
+};
+#define SIMTEMP_NL_ATTR_MAX (__SIMTEMP_NL_ATTR_MAX - 1)
+
+#endif // NXP_SIMTEMP_NETLINK_H
@@ -0,0 +1,200 @@
+//
+// simtemp_core.c - rings, generator and threshold logic shared by
+// nxp_simtemp.ko and user/core/libsimtemp_core.a (see simtemp_core.h).
+//
+// Every function expects the caller to hold the lock protecting its state.
+//
+
+#include "simtemp_core.h"
+
+// Push a sample; false (sample dropped) when the ring is full
+bool simtemp_ring_push(struct simtemp_ring *ring, const struct simtemp_sample *sample)
+{
+    if (ring->count >= SIMTEMP_BUFFER_SIZE)
+        return false;
+
+    ring->buffer[ring->head] = *sample;
+    ring->head = (ring->head + 1) % SIMTEMP_BUFFER_SIZE;
+    ring->count++;
+    return true;
+}
+
+// Pop up to 'max' samples, oldest first. Returns how many were copied.
+unsigned int simtemp_ring_pop(struct simtemp_ring *ring, struct simtemp_sample *out,
+                              unsigned int max)
+{
+    unsigned int n = 0;
+
+    while (ring->count > 0 && n < max) {
+        out[n++] = ring->buffer[ring->tail];
+        ring->tail = (ring->tail + 1) % SIMTEMP_BUFFER_SIZE;
+        ring->count--;
+    }
+    return n;
+}
+
+// Record a tick in the history ring (overwrites the oldest)
+void simtemp_history_push(struct simtemp_history *hist, const struct simtemp_sample *sample)
+{
+    hist->buffer[hist->head] = *sample;
+    hist->head = (hist->head + 1) % SIMTEMP_HISTORY_SIZE;
+    if (hist->count < SIMTEMP_HISTORY_SIZE)
+        hist->count++;
+}
+
+// Copy the newest 'max' entries, oldest first, without consuming them
+unsigned int simtemp_history_peek(const struct simtemp_history *hist, struct simtemp_sample *out,
+                                  unsigned int max)
+{
+    unsigned int n = min_t(unsigned int, max, hist->count);
+    unsigned int start = (hist->head - n + SIMTEMP_HISTORY_SIZE) % SIMTEMP_HISTORY_SIZE;
+    unsigned int first = min_t(unsigned int, n, SIMTEMP_HISTORY_SIZE - start);
+
+    memcpy(out, &hist->buffer[start], first * sizeof(*out));
+    memcpy(out + first, hist->buffer, (n - first) * sizeof(*out));
+    return n;
+}
+
+// Store a frame (column 'head' of every block); false when the ring is full
+bool simtemp_frame_ring_push(struct simtemp_frame_ring *fr, u64 timestamp_ns, u32 alert_mask,
+                             const s32 *temps, unsigned int channels)
+{
+    unsigned int ch;
+
+    if (fr->count >= SIMTEMP_FRAME_RING_SIZE)
+        return false;
+
+    fr->timestamp_ns[fr->head] = timestamp_ns;
+    fr->alert_mask[fr->head] = alert_mask;
+    for (ch = 0; ch < channels; ch++)
+        fr->temp_mC[ch][fr->head] = temps[ch];
+    fr->head = (fr->head + 1) % SIMTEMP_FRAME_RING_SIZE;
+    fr->count++;
+    return true;
+}
+
+// Copy 'n' ring slots starting at 'tail' into a linear array (handles wrap)
+static void simtemp_frame_copy(void *dst, const void *src, unsigned int tail, unsigned int n,
+                               size_t elem)
+{
+    unsigned int first = min_t(unsigned int, n, SIMTEMP_FRAME_RING_SIZE - tail);
+
+    memcpy(dst, (const char *)src + tail * elem, first * elem);
+    memcpy((char *)dst + first * elem, src, (n - first) * elem);
+}
+
+// Pop up to 'max' frames as SoA blocks (temps holds 'channels' blocks of n)
+unsigned int simtemp_frame_ring_pop(struct simtemp_frame_ring *fr, unsigned int channels,
+                                    unsigned int max, u64 *ts, u32 *mask, s32 *temps)
+{
+    unsigned int n = min_t(unsigned int, max, fr->count);
+    unsigned int ch;
+
+    if (n == 0)
+        return 0;
+
+    simtemp_frame_copy(ts, fr->timestamp_ns, fr->tail, n, sizeof(*ts));
+    simtemp_frame_copy(mask, fr->alert_mask, fr->tail, n, sizeof(*mask));
+    for (ch = 0; ch < channels; ch++)
+        simtemp_frame_copy(temps + ch * n, fr->temp_mC[ch], fr->tail, n, sizeof(*temps));
+
+    fr->tail = (fr->tail + n) % SIMTEMP_FRAME_RING_SIZE;
+    fr->count -= n;
+    return n;
+}
+
+// One temperature reading for 'mode'
+s32 simtemp_generate_temp(enum simtemp_mode mode, u64 seq, unsigned int channel)
+{
+    switch (mode) {
+        case SIMTEMP_MODE_NORMAL:
+        default:
+            // 25.000 to 35.000 mC
+            return 25000 + (get_random_u32() % 10001);
+        case SIMTEMP_MODE_NOISY:
+            // 20.000 to 40.000 mC
+            return 20000 + (get_random_u32() % 20001);
+        case SIMTEMP_MODE_RAMP:
+            // Simple ramp; each zone is phase-shifted so channels are distinguishable
+            return ((seq + channel * 500) % 20000) + 25000;
+    }
+}
+
+// Single-channel threshold edge detection (true = newly crossed)
+bool simtemp_threshold_update(bool *flag, s32 temp_mC, s32 threshold_mC)
+{
+    if (temp_mC <= threshold_mC) {
+        // If flag was not set before, this is a new event
+        if (!*flag) {
+            *flag = true;
+            return true;
+        }
+        return false;
+    }
+
+    // Reset flag if temperature is back above threshold
+    *flag = false;
+    return false;
+}
+
+// Threshold evaluation: branch-free over contiguous arrays, so the
+// compiler can vectorize it (compare + shift + OR reduction)
+u32 simtemp_threshold_mask(const s32 *temps, const s32 *thresholds, unsigned int n)
+{
+    unsigned int ch;
+    u32 mask = 0;
+
+    for (ch = 0; ch < n; ch++)
+        mask |= (u32)(temps[ch] <= thresholds[ch]) << ch;
+    return mask;
+}
+
+// Validate an adaptive sampling config (sysfs and ioctl share it)
+bool simtemp_adaptive_valid(const struct simtemp_adaptive *cfg)
+{
+    return cfg->policy <= SIMTEMP_ADAPTIVE_HALVE &&
+           cfg->min_ms >= 1 && cfg->min_ms <= cfg->max_ms && cfg->max_ms <= 10000 &&
+           cfg->step_ms >= 1 && cfg->step_ms <= 10000 &&
+           cfg->band_mC >= 0 && cfg->slope_mC > 0;
+}
+
+static s64 simtemp_dist(s32 a, s32 b)
+{
+    s64 d = (s64)a - b;
+
+    return d < 0 ? -d : d;
+}
+
+// Pick the period of the next tick from this tick's temperatures.
+// Slope is the per-tick move of a smoothed temperature (EWMA, weight
+// 1/2^SIMTEMP_ADAPTIVE_EWMA_SHIFT), so uniform generator noise averages out
+// and only a sustained change registers as "moving fast".
+unsigned int simtemp_adaptive_next(const struct simtemp_adaptive *cfg, unsigned int period_ms,
+                                   s32 *avg_temps, const s32 *temps, const s32 *thresholds,
+                                   unsigned int n)
+{
+    s64 dist = S64_MAX;
+    s64 delta = 0;
+    unsigned int ch;
+
+    // Closest channel to its threshold, fastest moving channel
+    for (ch = 0; ch < n; ch++) {
+        s64 step = ((s64)temps[ch] - avg_temps[ch]) >> SIMTEMP_ADAPTIVE_EWMA_SHIFT;
+
+        dist = min_t(s64, dist, simtemp_dist(temps[ch], thresholds[ch]));
+        delta = max_t(s64, delta, step < 0 ? -step : step);
+        avg_temps[ch] += step; // stays between the old average and temps[ch]
+    }
+
+    if (cfg->policy == SIMTEMP_ADAPTIVE_OFF)
+        return period_ms;
+
+    if (dist <= cfg->band_mC || delta >= cfg->slope_mC)
+        // Urgent: sample faster (fast attack)
+        period_ms = (cfg->policy == SIMTEMP_ADAPTIVE_JUMP) ? cfg->min_ms : period_ms / 2;
+    else
+        // Calm: stretch back toward max_ms (slow release)
+        period_ms += cfg->step_ms;
+
+    return clamp_t(unsigned int, period_ms, cfg->min_ms, cfg->max_ms);
+}
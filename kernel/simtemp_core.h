@@ -0,0 +1,95 @@
+#ifndef SIMTEMP_CORE_H
+#define SIMTEMP_CORE_H
+
+//
+// simtemp_core - the kernel-agnostic part of the driver: the delivery,
+// history and frame rings, the temperature generator and the threshold /
+// adaptive sampling logic.
+//
+// Nothing here locks, sleeps or touches user memory: the driver calls it
+// under dev->lock, and the userspace build (user/core) runs the very same
+// object code for benchmarks and fuzzing through simtemp_port.h.
+//
+
+#include "simtemp_port.h"
+#include "nxp_simtemp_ioctl.h"
+
+#define SIMTEMP_BUFFER_SIZE 16   // ring buffer size
+#define SIMTEMP_FRAME_RING_SIZE 64 // frame ring size (multi-channel mode)
+
+//Simulation modes as required by the challenge
+enum simtemp_mode {
+    SIMTEMP_MODE_NORMAL, // e.g., 25-35 C
+    SIMTEMP_MODE_NOISY,  // e.g., 20-40 C
+    SIMTEMP_MODE_RAMP,   // e.g., ramp up
+};
+
+// Delivery ring for read()/SIMTEMP_IOC_READ_BATCH (new samples dropped when full)
+struct simtemp_ring {
+    struct simtemp_sample buffer[SIMTEMP_BUFFER_SIZE];
+    int head;
+    int tail;
+    int count;
+};
+
+// History ring: written on every tick, never consumed (overwrites the oldest)
+struct simtemp_history {
+    struct simtemp_sample buffer[SIMTEMP_HISTORY_SIZE];
+    int head;
+    int count;
+};
+
+// Multi-channel frame ring, kept struct-of-arrays like the read() layout
+struct simtemp_frame_ring {
+    __u64 timestamp_ns[SIMTEMP_FRAME_RING_SIZE];
+    __u32 alert_mask[SIMTEMP_FRAME_RING_SIZE];
+    __s32 temp_mC[SIMTEMP_MAX_CHANNELS][SIMTEMP_FRAME_RING_SIZE];
+    int head;
+    int tail;
+    int count;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Delivery ring
+bool simtemp_ring_push(struct simtemp_ring *ring, const struct simtemp_sample *sample);
+unsigned int simtemp_ring_pop(struct simtemp_ring *ring, struct simtemp_sample *out,
+                              unsigned int max);
+
+// History ring: peek copies the newest 'max' entries, oldest first
+void simtemp_history_push(struct simtemp_history *hist, const struct simtemp_sample *sample);
+unsigned int simtemp_history_peek(const struct simtemp_history *hist, struct simtemp_sample *out,
+                                  unsigned int max);
+
+// Frame ring: pop writes ts[n], mask[n], then temps[channels][n] (the read() blocks)
+bool simtemp_frame_ring_push(struct simtemp_frame_ring *fr, u64 timestamp_ns, u32 alert_mask,
+                             const s32 *temps, unsigned int channels);
+unsigned int simtemp_frame_ring_pop(struct simtemp_frame_ring *fr, unsigned int channels,
+                                    unsigned int max, u64 *ts, u32 *mask, s32 *temps);
+
+// Generator: 'seq' drives the ramp, 'channel' phase-shifts it per zone
+s32 simtemp_generate_temp(enum simtemp_mode mode, u64 seq, unsigned int channel);
+
+// Threshold: alert while temp <= threshold. The single-channel form updates
+// the alert flag and returns true on the rising edge; the mask form returns
+// bit c = channel c at/below its threshold.
+bool simtemp_threshold_update(bool *flag, s32 temp_mC, s32 threshold_mC);
+u32 simtemp_threshold_mask(const s32 *temps, const s32 *thresholds, unsigned int n);
+
+// Adaptive sampling (see struct simtemp_adaptive). next() also moves the
+// smoothed 'avg_temps' toward 'temps' (the caller seeds them with a first
+// sample); with policy OFF it returns 'period_ms'.
+#define SIMTEMP_ADAPTIVE_EWMA_SHIFT 4   // weight 1/16 per tick
+
+bool simtemp_adaptive_valid(const struct simtemp_adaptive *cfg);
+unsigned int simtemp_adaptive_next(const struct simtemp_adaptive *cfg, unsigned int period_ms,
+                                   s32 *avg_temps, const s32 *temps, const s32 *thresholds,
+                                   unsigned int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMTEMP_CORE_H
@@ -0,0 +1,716 @@
+//
+// simtemp_kunit.c - KUnit tests and in-kernel microbenchmarks for the ring,
+// generator and timer path of nxp_simtemp.
+//
+// Not a separate object: nxp_simtemp_main.c includes this file at its end
+// when CONFIG_NXP_SIMTEMP_KUNIT_TEST is set, so the static timer callback
+// and sysfs handlers are exercised exactly as the driver runs them.
+//
+//   UML/QEMU (no hardware):  bash scripts/run_kunit.sh <kernel source tree>
+//   Running kernel:          make -C kernel KUNIT=1, modprobe kunit, insmod
+//
+// Each test gets a private simtemp_dev (no cdev, no sysfs files): a plain
+// struct device stands in for simdev->device so the sysfs store handlers
+// and the netlink device name work unchanged.
+//
+// The timing cases print "ns/op" with kunit_info() and only fail above
+// SIMTEMP_KUNIT_MAX_NS, so slow emulators do not make the suite flaky but
+// gross regressions still fail it.
+//
+
+#include <kunit/test.h>
+#include <linux/completion.h>
+#include <linux/kthread.h>
+
+#define SIMTEMP_KUNIT_BENCH_OPS 20000     // iterations per timing case
+#define SIMTEMP_KUNIT_MAX_NS 100000ULL    // 100 us per operation: clearly broken
+#define SIMTEMP_KUNIT_PRODUCER_TICKS 2000
+
+struct simtemp_kunit_ctx {
+    struct simtemp_dev *simdev;
+    struct device *attr_dev;    // stand-in for simdev->device
+
+    // Producer thread (concurrency cases)
+    struct completion producer_done;
+    unsigned int producer_ticks; // 0 = run until 'stop'
+    bool stop;
+};
+
+static const char *const simtemp_kunit_modes[] = { "normal", "noisy", "ramp" };
+
+static int simtemp_kunit_init(struct kunit *test)
+{
+    struct simtemp_kunit_ctx *ctx;
+    struct simtemp_dev *simdev;
+
+    ctx = kunit_kzalloc(test, sizeof(*ctx), GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, ctx);
+    simdev = kunit_kzalloc(test, sizeof(*simdev), GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, simdev);
+    ctx->attr_dev = kunit_kzalloc(test, sizeof(*ctx->attr_dev), GFP_KERNEL);
+    KUNIT_ASSERT_NOT_NULL(test, ctx->attr_dev);
+
+    ctx->attr_dev->init_name = "simtemp-kunit";
+    dev_set_drvdata(ctx->attr_dev, simdev);
+    simdev->device = ctx->attr_dev;
+
+    // Same defaults as simtemp_probe(), but with a period long enough that
+    // the timer re-armed by each tick never fires during a test
+    spin_lock_init(&simdev->lock);
+    init_waitqueue_head(&simdev->read_queue);
+    init_waitqueue_head(&simdev->threshold_queue);
+    simdev->channels = 1;
+    simdev->mode = SIMTEMP_MODE_NORMAL;
+    simdev->interval_ms = 10000;
+    simdev->effective_ms = simdev->interval_ms;
+    simdev->start_ns = ktime_get_ns();
+    simtemp_set_threshold_locked(simdev, 27000);
+    simdev->adaptive.policy = SIMTEMP_ADAPTIVE_OFF;
+    simdev->adaptive.min_ms = 10;
+    simdev->adaptive.max_ms = 1000;
+    simdev->adaptive.step_ms = 50;
+    simdev->adaptive.band_mC = 2000;
+    simdev->adaptive.slope_mC = 1000;
+    timer_setup(&simdev->timer, simtemp_timer_callback, 0);
+
+    init_completion(&ctx->producer_done);
+    ctx->simdev = simdev;
+    test->priv = ctx;
+    return 0;
+}
+
+static void simtemp_kunit_exit(struct kunit *test)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+
+    del_timer_sync(&ctx->simdev->timer);
+}
+
+// One timer tick. The real callback runs in softirq context and uses plain
+// spin_lock(), so bottom halves stay off like they would there.
+static void simtemp_kunit_tick(struct simtemp_dev *simdev)
+{
+    local_bh_disable();
+    simtemp_timer_callback(&simdev->timer);
+    local_bh_enable();
+}
+
+// Read-path dequeue (same critical section as simtemp_read())
+static unsigned int simtemp_kunit_drain(struct simtemp_dev *simdev, struct simtemp_sample *out,
+                                        unsigned int max)
+{
+    unsigned int n;
+
+    spin_lock_bh(&simdev->lock);
+    n = simtemp_ring_pop(&simdev->ring, out, max);
+    spin_unlock_bh(&simdev->lock);
+    return n;
+}
+
+// Write a sysfs attribute through its store handler
+static ssize_t simtemp_kunit_store(struct simtemp_kunit_ctx *ctx,
+                                   ssize_t (*store)(struct device *, struct device_attribute *,
+                                                    const char *, size_t),
+                                   const char *val)
+{
+    return store(ctx->attr_dev, NULL, val, strlen(val));
+}
+
+static int simtemp_kunit_producer(void *data)
+{
+    struct simtemp_kunit_ctx *ctx = data;
+    unsigned int i;
+
+    for (i = 0; ctx->producer_ticks ? i < ctx->producer_ticks : !READ_ONCE(ctx->stop); i++) {
+        simtemp_kunit_tick(ctx->simdev);
+        cond_resched();
+    }
+    complete(&ctx->producer_done);
+    return 0;
+}
+
+static void simtemp_kunit_start_producer(struct kunit *test, unsigned int ticks)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+    struct task_struct *task;
+
+    ctx->producer_ticks = ticks;
+    task = kthread_run(simtemp_kunit_producer, ctx, "simtemp-kunit");
+    KUNIT_ASSERT_FALSE(test, IS_ERR(task));
+}
+
+// --- Ring, history and frame ring ---
+
+static void simtemp_test_ring_wraparound(struct kunit *test)
+{
+    struct simtemp_ring *ring = kunit_kzalloc(test, sizeof(*ring), GFP_KERNEL);
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    struct simtemp_sample s = { .flags = SIMTEMP_FLAG_NEW_SAMPLE };
+    u64 pushed = 0, popped = 0;
+    unsigned int round, i, n;
+
+    KUNIT_ASSERT_NOT_NULL(test, ring);
+
+    // 11 per round is coprime to 16, so head/tail visit every slot
+    for (round = 0; round < 8; round++) {
+        for (i = 0; i < 11; i++) {
+            s.timestamp_ns = pushed++;
+            KUNIT_EXPECT_TRUE(test, simtemp_ring_push(ring, &s));
+        }
+        n = simtemp_ring_pop(ring, out, SIMTEMP_BUFFER_SIZE);
+        KUNIT_EXPECT_EQ(test, n, 11U);
+        for (i = 0; i < n; i++)
+            KUNIT_EXPECT_EQ(test, (u64)out[i].timestamp_ns, popped++);
+    }
+    KUNIT_EXPECT_EQ(test, ring->count, 0);
+    KUNIT_EXPECT_EQ(test, ring->head, ring->tail);
+    KUNIT_EXPECT_EQ(test, simtemp_ring_pop(ring, out, SIMTEMP_BUFFER_SIZE), 0U);
+}
+
+static void simtemp_test_history_window(struct kunit *test)
+{
+    struct simtemp_history *hist = kunit_kzalloc(test, sizeof(*hist), GFP_KERNEL);
+    struct simtemp_sample *out = kunit_kcalloc(test, SIMTEMP_HISTORY_SIZE, sizeof(*out), GFP_KERNEL);
+    struct simtemp_sample s = { .flags = SIMTEMP_FLAG_NEW_SAMPLE };
+    u64 i;
+
+    KUNIT_ASSERT_NOT_NULL(test, hist);
+    KUNIT_ASSERT_NOT_NULL(test, out);
+
+    for (i = 0; i < SIMTEMP_HISTORY_SIZE + 100; i++) {
+        s.timestamp_ns = i;
+        simtemp_history_push(hist, &s);
+    }
+    KUNIT_EXPECT_EQ(test, hist->count, SIMTEMP_HISTORY_SIZE);
+
+    // Newest 8, oldest first, across the wrap point
+    KUNIT_EXPECT_EQ(test, simtemp_history_peek(hist, out, 8), 8U);
+    for (i = 0; i < 8; i++)
+        KUNIT_EXPECT_EQ(test, (u64)out[i].timestamp_ns, SIMTEMP_HISTORY_SIZE + 92 + i);
+
+    // Whole window: the 100 oldest were overwritten; peeking consumes nothing
+    KUNIT_EXPECT_EQ(test, simtemp_history_peek(hist, out, SIMTEMP_HISTORY_SIZE + 1),
+                    (unsigned int)SIMTEMP_HISTORY_SIZE);
+    KUNIT_EXPECT_EQ(test, (u64)out[0].timestamp_ns, 100ULL);
+    KUNIT_EXPECT_EQ(test, hist->count, SIMTEMP_HISTORY_SIZE);
+}
+
+static void simtemp_test_frame_ring_wraparound(struct kunit *test)
+{
+    struct simtemp_frame_ring *fr = kunit_kzalloc(test, sizeof(*fr), GFP_KERNEL);
+    const unsigned int channels = 3, batch = 40;
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    u64 ts[SIMTEMP_FRAME_RING_SIZE];
+    u32 mask[SIMTEMP_FRAME_RING_SIZE];
+    s32 *out = kunit_kcalloc(test, channels * SIMTEMP_FRAME_RING_SIZE, sizeof(*out), GFP_KERNEL);
+    u64 pushed = 0, popped = 0;
+    unsigned int round, i, ch, n;
+
+    KUNIT_ASSERT_NOT_NULL(test, fr);
+    KUNIT_ASSERT_NOT_NULL(test, out);
+
+    for (round = 0; round < 4; round++) {
+        for (i = 0; i < batch; i++, pushed++) {
+            for (ch = 0; ch < channels; ch++)
+                temps[ch] = pushed * 10 + ch;
+            KUNIT_EXPECT_TRUE(test, simtemp_frame_ring_push(fr, pushed, (u32)pushed, temps, channels));
+        }
+        n = simtemp_frame_ring_pop(fr, channels, SIMTEMP_FRAME_RING_SIZE, ts, mask, out);
+        KUNIT_EXPECT_EQ(test, n, batch);
+
+        // SoA: all timestamps, all masks, then one block of n per channel
+        for (i = 0; i < n; i++, popped++) {
+            KUNIT_EXPECT_EQ(test, ts[i], popped);
+            KUNIT_EXPECT_EQ(test, mask[i], (u32)popped);
+            for (ch = 0; ch < channels; ch++)
+                KUNIT_EXPECT_EQ(test, out[ch * n + i], (s32)(popped * 10 + ch));
+        }
+    }
+
+    // Full ring refuses the 65th frame
+    for (i = 0; i < SIMTEMP_FRAME_RING_SIZE; i++)
+        KUNIT_EXPECT_TRUE(test, simtemp_frame_ring_push(fr, i, 0, temps, channels));
+    KUNIT_EXPECT_FALSE(test, simtemp_frame_ring_push(fr, i, 0, temps, channels));
+}
+
+// Ticks with no reader: the ring keeps the oldest 16, later ticks are dropped
+// but still counted in 'ticks' and still recorded in the history
+static void simtemp_test_ring_overflow(struct kunit *test)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+    struct simtemp_dev *simdev = ctx->simdev;
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    unsigned int i, n;
+
+    simdev->mode = SIMTEMP_MODE_RAMP;   // temp = 25000 + samples_generated
+    simtemp_set_threshold_locked(simdev, 0);
+
+    for (i = 0; i < SIMTEMP_BUFFER_SIZE + 4; i++)
+        simtemp_kunit_tick(simdev);
+
+    KUNIT_EXPECT_EQ(test, simdev->ring.count, SIMTEMP_BUFFER_SIZE);
+    KUNIT_EXPECT_EQ(test, simdev->stats.ticks, (u64)SIMTEMP_BUFFER_SIZE + 4);
+    KUNIT_EXPECT_EQ(test, simdev->stats.samples_generated, (u64)SIMTEMP_BUFFER_SIZE);
+    KUNIT_EXPECT_EQ(test, simdev->history.count, SIMTEMP_BUFFER_SIZE + 4);
+
+    n = simtemp_kunit_drain(simdev, out, SIMTEMP_BUFFER_SIZE);
+    KUNIT_EXPECT_EQ(test, n, (unsigned int)SIMTEMP_BUFFER_SIZE);
+    for (i = 0; i < n; i++)
+        KUNIT_EXPECT_EQ(test, (s32)out[i].temp_mC, (s32)(25000 + i));
+
+    // Space again: the next sample follows on from the last delivered one
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simtemp_kunit_drain(simdev, out, 1), 1U);
+    KUNIT_EXPECT_EQ(test, (s32)out[0].temp_mC, (s32)(25000 + SIMTEMP_BUFFER_SIZE));
+}
+
+// Timer in a kthread vs. the read path in the test thread: nothing lost or
+// duplicated beyond what the overflow accounting reports
+static void simtemp_test_producer_consumer(struct kunit *test)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+    struct simtemp_dev *simdev = ctx->simdev;
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    u64 received = 0;
+    unsigned int mismatches = 0;
+    unsigned int i, n;
+
+    simdev->mode = SIMTEMP_MODE_RAMP;   // delivered temps must be consecutive
+    simtemp_set_threshold_locked(simdev, 0);
+    simtemp_kunit_start_producer(test, SIMTEMP_KUNIT_PRODUCER_TICKS);
+
+    for (;;) {
+        bool done = completion_done(&ctx->producer_done);
+
+        n = simtemp_kunit_drain(simdev, out, 1 + received % SIMTEMP_BUFFER_SIZE);
+        // No ASSERT here: bailing out would free simdev under the producer
+        for (i = 0; i < n; i++, received++)
+            if (out[i].temp_mC != (s32)(25000 + received))
+                mismatches++;
+        if (n == 0) {
+            if (done)
+                break;
+            cond_resched();
+        }
+    }
+    wait_for_completion(&ctx->producer_done);
+
+    KUNIT_EXPECT_EQ(test, mismatches, 0U);
+    KUNIT_EXPECT_EQ(test, simdev->stats.ticks, (u64)SIMTEMP_KUNIT_PRODUCER_TICKS);
+    KUNIT_EXPECT_EQ(test, received, simdev->stats.samples_generated);
+    KUNIT_EXPECT_EQ(test, simdev->ring.count, 0);
+    kunit_info(test, "%llu of %u ticks delivered, %llu dropped (ring full)\n",
+               received, SIMTEMP_KUNIT_PRODUCER_TICKS,
+               SIMTEMP_KUNIT_PRODUCER_TICKS - received);
+}
+
+// --- Threshold ---
+
+static void simtemp_test_threshold_edges(struct kunit *test)
+{
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+    bool flag = false;
+    unsigned int ch;
+
+    // Equal counts as crossed; one event per excursion
+    KUNIT_EXPECT_TRUE(test, simtemp_threshold_update(&flag, 30000, 30000));
+    KUNIT_EXPECT_TRUE(test, flag);
+    KUNIT_EXPECT_FALSE(test, simtemp_threshold_update(&flag, 30000, 30000));
+    KUNIT_EXPECT_FALSE(test, simtemp_threshold_update(&flag, 29999, 30000));
+    KUNIT_EXPECT_FALSE(test, simtemp_threshold_update(&flag, 30001, 30000));
+    KUNIT_EXPECT_FALSE(test, flag);
+    KUNIT_EXPECT_TRUE(test, simtemp_threshold_update(&flag, 30000, 30000));
+
+    // Extremes do not overflow the comparison
+    flag = false;
+    KUNIT_EXPECT_TRUE(test, simtemp_threshold_update(&flag, S32_MIN, S32_MAX));
+    KUNIT_EXPECT_FALSE(test, simtemp_threshold_update(&flag, S32_MAX, S32_MIN));
+
+    // Mask: odd channels exactly at threshold, even ones 1 mC above (bit 31 included)
+    for (ch = 0; ch < SIMTEMP_MAX_CHANNELS; ch++) {
+        thresholds[ch] = 30000 + ch;
+        temps[ch] = thresholds[ch] + !(ch & 1);
+    }
+    KUNIT_EXPECT_EQ(test, simtemp_threshold_mask(temps, thresholds, SIMTEMP_MAX_CHANNELS), 0xaaaaaaaaU);
+    KUNIT_EXPECT_EQ(test, simtemp_threshold_mask(temps, thresholds, 4), 0xaU);
+}
+
+// Through the timer: POLLPRI event and alert counter on rising edges only
+static void simtemp_test_threshold_timer(struct kunit *test)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+    struct simtemp_dev *simdev = ctx->simdev;
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    unsigned int i, n;
+
+    // Normal mode is 25..35 C: 50 C is always crossed, 10 C never
+    KUNIT_ASSERT_EQ(test, simtemp_kunit_store(ctx, threshold_mC_store, "50000"), (ssize_t)5);
+    for (i = 0; i < 5; i++)
+        simtemp_kunit_tick(simdev);
+
+    KUNIT_EXPECT_TRUE(test, simdev->threshold_flag);
+    KUNIT_EXPECT_TRUE(test, simdev->threshold_event);
+    KUNIT_EXPECT_EQ(test, simdev->stats.alerts_triggered, 1ULL);
+
+    n = simtemp_kunit_drain(simdev, out, SIMTEMP_BUFFER_SIZE);
+    KUNIT_EXPECT_EQ(test, n, 5U);
+    KUNIT_EXPECT_TRUE(test, out[0].flags & SIMTEMP_FLAG_THRESHOLD_CROSSED);
+    for (i = 1; i < n; i++)
+        KUNIT_EXPECT_FALSE(test, out[i].flags & SIMTEMP_FLAG_THRESHOLD_CROSSED);
+
+    // Back above re-arms, the next crossing counts again
+    simtemp_kunit_store(ctx, threshold_mC_store, "10000");
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_FALSE(test, simdev->threshold_flag);
+    simtemp_kunit_store(ctx, threshold_mC_store, "50000");
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->stats.alerts_triggered, 2ULL);
+
+    KUNIT_EXPECT_EQ(test, simtemp_kunit_store(ctx, threshold_mC_store, "hot"), (ssize_t)-EINVAL);
+}
+
+static void simtemp_test_threshold_channels(struct kunit *test)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+    struct simtemp_dev *simdev = ctx->simdev;
+    struct simtemp_sample stale = { .temp_mC = 25000, .flags = SIMTEMP_FLAG_NEW_SAMPLE };
+    char *page = kunit_kzalloc(test, PAGE_SIZE, GFP_KERNEL);  // sysfs_emit_at() wants a page
+    unsigned int spaces;
+    ssize_t len, i;
+
+    KUNIT_ASSERT_NOT_NULL(test, page);
+    KUNIT_ASSERT_EQ(test, simtemp_kunit_store(ctx, channels_store, "4"), (ssize_t)1);
+    simtemp_kunit_store(ctx, channel_thresholds_mC_store, "50000 50000 10000 10000");
+
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->channel_alert_mask, 0x3U);
+    KUNIT_EXPECT_EQ(test, simdev->stats.alerts_triggered, 2ULL);
+    KUNIT_EXPECT_EQ(test, simdev->frames.count, 1);
+    KUNIT_EXPECT_EQ(test, simdev->frames.alert_mask[0], 0x3U);
+    KUNIT_EXPECT_EQ(test, simdev->stats.samples_generated, 4ULL);
+
+    // Still crossed: no new events; channel 2 crossing adds exactly one
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->stats.alerts_triggered, 2ULL);
+    simtemp_kunit_store(ctx, channel_thresholds_mC_store, "50000 50000 50000 10000");
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->channel_alert_mask, 0x7U);
+    KUNIT_EXPECT_EQ(test, simdev->stats.alerts_triggered, 3ULL);
+
+    // temperature keeps reporting all channels after a reader drains the ring
+    spin_lock_bh(&simdev->lock);
+    simdev->frames.tail = simdev->frames.head;
+    simdev->frames.count = 0;
+    spin_unlock_bh(&simdev->lock);
+    len = temperature_show(ctx->attr_dev, NULL, page);
+    KUNIT_EXPECT_GT(test, len, (ssize_t)0);
+    KUNIT_EXPECT_EQ(test, page[len - 1], '\n');
+    for (i = 0, spaces = 0; i < len; i++)
+        spaces += page[i] == ' ';
+    KUNIT_EXPECT_EQ(test, spaces, 3U);
+
+    // Width change drops frames of the old layout
+    simtemp_kunit_store(ctx, channels_store, "8");
+    KUNIT_EXPECT_EQ(test, simdev->frames.count, 0);
+    KUNIT_EXPECT_EQ(test, simdev->channel_alert_mask, 0U);
+
+    // ...and back to one channel drops samples queued before the switch
+    KUNIT_EXPECT_TRUE(test, simtemp_ring_push(&simdev->ring, &stale));
+    simtemp_kunit_store(ctx, channels_store, "1");
+    KUNIT_EXPECT_EQ(test, simdev->ring.count, 0);
+    KUNIT_EXPECT_EQ(test, simtemp_kunit_store(ctx, channels_store, "33"), (ssize_t)-EINVAL);
+}
+
+// --- Configuration ---
+
+// Second-scale periods so the real timer never fires mid-test
+static void simtemp_kunit_adaptive_range(struct kunit *test, const char *policy)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+
+    simtemp_kunit_store(ctx, adaptive_max_ms_store, "4000");
+    simtemp_kunit_store(ctx, adaptive_min_ms_store, "1000");
+    simtemp_kunit_store(ctx, adaptive_step_ms_store, "1000");
+    KUNIT_ASSERT_EQ(test, simtemp_kunit_store(ctx, adaptive_store, policy), (ssize_t)strlen(policy));
+}
+
+static void simtemp_test_adaptive_period(struct kunit *test)
+{
+    struct simtemp_kunit_ctx *ctx = test->priv;
+    struct simtemp_dev *simdev = ctx->simdev;
+    char buf[16];
+
+    simdev->mode = SIMTEMP_MODE_RAMP;   // +1 mC per tick: calm
+    simtemp_set_threshold_locked(simdev, 0);
+    simtemp_kunit_adaptive_range(test, "jump");
+
+    // The first tick seeds the average: no start-up "slope"
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->avg_channels, 1U);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, 4000U);
+
+    // Calm ticks step back to max
+    simdev->effective_ms = 1000;
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, 2000U);
+    simtemp_kunit_tick(simdev);
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, 4000U);
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, 4000U);
+
+    // Next ramp sample lands within band_mC (2000) of the threshold: straight to min
+    snprintf(buf, sizeof(buf), "%d", (int)(25000 + simdev->stats.samples_generated + 1500));
+    simtemp_kunit_store(ctx, threshold_mC_store, buf);
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, 1000U);
+
+    // Halve policy from max: 4000 -> 2000 -> 1000 -> 1000 (clamped)
+    simtemp_kunit_store(ctx, adaptive_store, "halve");
+    simdev->effective_ms = 4000;
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, 2000U);
+    simtemp_kunit_tick(simdev);
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, 1000U);
+
+    // Inconsistent bounds are rejected and change nothing
+    KUNIT_EXPECT_EQ(test, simtemp_kunit_store(ctx, adaptive_min_ms_store, "5000"), (ssize_t)-EINVAL);
+    KUNIT_EXPECT_EQ(test, simtemp_kunit_store(ctx, adaptive_max_ms_store, "500"), (ssize_t)-EINVAL);
+    KUNIT_EXPECT_EQ(test, simdev->adaptive.min_ms, 1000U);
+    KUNIT_EXPECT_EQ(test, simdev->adaptive.max_ms, 4000U);
+
+    // Off: back to the fixed sampling_ms
+    simtemp_kunit_store(ctx, adaptive_store, "off");
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, simdev->interval_ms);
+    simtemp_kunit_tick(simdev);
+    KUNIT_EXPECT_EQ(test, simdev->effective_ms, simdev->interval_ms);
+}
+
+// Normal and noisy draw a fresh value every tick. Far from the threshold
+// that noise alone must not count as a slope, or the period never backs off.
+static void simtemp_test_adaptive_noise(struct kunit *test)
+{
+    static const enum simtemp_mode modes[] = { SIMTEMP_MODE_NORMAL, SIMTEMP_MODE_NOISY };
+    struct simtemp_dev *simdev = ((struct simtemp_kunit_ctx *)test->priv)->simdev;
+    unsigned int m, i, prev, urgent;
+
+    simtemp_set_threshold_locked(simdev, 0);
+    simtemp_kunit_adaptive_range(test, "jump");
+
+    for (m = 0; m < ARRAY_SIZE(modes); m++) {
+        simdev->mode = modes[m];
+        simdev->effective_ms = 1000;
+        urgent = 0;
+
+        for (i = 0; i < 500; i++) {
+            prev = simdev->effective_ms;
+            simtemp_kunit_tick(simdev);
+            if (simdev->effective_ms < prev || (i > 0 && simdev->effective_ms == 1000))
+                urgent++;
+        }
+        KUNIT_EXPECT_EQ_MSG(test, urgent, 0U, "mode %s", simtemp_kunit_modes[modes[m]]);
+        KUNIT_EXPECT_EQ(test, simdev->effective_ms, 4000U);
+    }
+}
+
+// The timer keeps ticking while every sysfs knob changes under it
+static void simtemp_test_config_during_sampling(struct kunit *test)
+{
+    static const char *const channels[] = { "1", "8", "32", "2", "1" };
+    static const char *const policies[] = { "jump", "halve", "off" };
+    struct simtemp_kunit_ctx *ctx = test->priv;
+    struct simtemp_dev *simdev = ctx->simdev;
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    struct {
+        int ring_count, frames_count;
+        unsigned int effective_ms, policy, min_ms, max_ms, channels;
+        u32 alert_mask;
+    } snap;
+    unsigned int i;
+
+    // Every store re-arms the real timer at effective_ms: keep all periods
+    // at 9-10 s (adaptive range included) so the kthread stays the only producer
+    KUNIT_ASSERT_EQ(test, simtemp_kunit_store(ctx, adaptive_max_ms_store, "10000"), (ssize_t)5);
+    KUNIT_ASSERT_EQ(test, simtemp_kunit_store(ctx, adaptive_min_ms_store, "9000"), (ssize_t)4);
+    KUNIT_ASSERT_EQ(test, simtemp_kunit_store(ctx, adaptive_step_ms_store, "1000"), (ssize_t)4);
+
+    simtemp_kunit_start_producer(test, 0);
+
+    for (i = 0; i < 200; i++) {
+        simtemp_kunit_store(ctx, mode_store, simtemp_kunit_modes[i % 3]);
+        simtemp_kunit_store(ctx, threshold_mC_store, (i & 1) ? "30000" : "20000");
+        simtemp_kunit_store(ctx, channels_store, channels[i % ARRAY_SIZE(channels)]);
+        simtemp_kunit_store(ctx, adaptive_store, policies[i % ARRAY_SIZE(policies)]);
+        simtemp_kunit_store(ctx, sampling_ms_store, (i & 2) ? "9000" : "10000");
+        simtemp_kunit_drain(simdev, out, SIMTEMP_BUFFER_SIZE);
+
+        // Consistent snapshot under the lock; KUnit may sleep on failure,
+        // so the expectations run after unlocking
+        spin_lock_bh(&simdev->lock);
+        snap.ring_count = simdev->ring.count;
+        snap.frames_count = simdev->frames.count;
+        snap.effective_ms = simdev->effective_ms;
+        snap.policy = simdev->adaptive.policy;
+        snap.min_ms = simdev->adaptive.min_ms;
+        snap.max_ms = simdev->adaptive.max_ms;
+        snap.channels = simdev->channels;
+        snap.alert_mask = simdev->channel_alert_mask;
+        spin_unlock_bh(&simdev->lock);
+
+        KUNIT_EXPECT_GE(test, snap.ring_count, 0);
+        KUNIT_EXPECT_LE(test, snap.ring_count, SIMTEMP_BUFFER_SIZE);
+        KUNIT_EXPECT_GE(test, snap.frames_count, 0);
+        KUNIT_EXPECT_LE(test, snap.frames_count, SIMTEMP_FRAME_RING_SIZE);
+        KUNIT_EXPECT_GE(test, snap.effective_ms, 1U);
+        KUNIT_EXPECT_LE(test, snap.effective_ms, 10000U);
+        if (snap.policy != SIMTEMP_ADAPTIVE_OFF) {
+            KUNIT_EXPECT_GE(test, snap.effective_ms, snap.min_ms);
+            KUNIT_EXPECT_LE(test, snap.effective_ms, snap.max_ms);
+        }
+        // Mask bits only for channels that exist
+        if (snap.channels < 32)
+            KUNIT_EXPECT_EQ(test, snap.alert_mask >> snap.channels, 0U);
+
+        cond_resched();
+    }
+
+    WRITE_ONCE(ctx->stop, true);
+    wait_for_completion(&ctx->producer_done);
+    KUNIT_EXPECT_GT(test, simdev->stats.ticks, 0ULL);
+    kunit_info(test, "%llu ticks during 200 config rounds\n", simdev->stats.ticks);
+}
+
+// --- Timing ---
+//
+// Operations are timed in batches of SIMTEMP_BUFFER_SIZE (one ring's worth)
+// so ktime_get_ns() is read twice per batch, not per operation; refilling or
+// emptying the ring between batches is not timed.
+
+static void simtemp_kunit_report(struct kunit *test, const char *what, u64 ns, unsigned int ops)
+{
+    u64 per_op = div_u64(ns, ops);
+
+    kunit_info(test, "%s: %llu ns/op (%u ops)\n", what, per_op, ops);
+    KUNIT_EXPECT_LT(test, per_op, SIMTEMP_KUNIT_MAX_NS);
+}
+
+// Timer-side enqueue: spin_lock() + push, bottom halves already off
+static void simtemp_bench_enqueue(struct kunit *test)
+{
+    struct simtemp_dev *simdev = ((struct simtemp_kunit_ctx *)test->priv)->simdev;
+    struct simtemp_sample s = { .temp_mC = 25000, .flags = SIMTEMP_FLAG_NEW_SAMPLE };
+    unsigned int ops = 0, i;
+    u64 t0, ns = 0;
+
+    while (ops < SIMTEMP_KUNIT_BENCH_OPS) {
+        local_bh_disable();
+        t0 = ktime_get_ns();
+        for (i = 0; i < SIMTEMP_BUFFER_SIZE; i++) {
+            spin_lock(&simdev->lock);
+            s.timestamp_ns = ops + i;
+            simtemp_ring_push(&simdev->ring, &s);
+            spin_unlock(&simdev->lock);
+        }
+        ns += ktime_get_ns() - t0;
+        local_bh_enable();
+        ops += SIMTEMP_BUFFER_SIZE;
+
+        KUNIT_ASSERT_EQ(test, simdev->ring.count, SIMTEMP_BUFFER_SIZE);
+        simdev->ring.head = simdev->ring.tail = simdev->ring.count = 0;
+        cond_resched();
+    }
+    simtemp_kunit_report(test, "enqueue", ns, ops);
+}
+
+// Read-path dequeue: spin_lock_bh() + pop of one record, as simtemp_read()
+static void simtemp_bench_dequeue(struct kunit *test)
+{
+    struct simtemp_dev *simdev = ((struct simtemp_kunit_ctx *)test->priv)->simdev;
+    struct simtemp_sample s = { .temp_mC = 25000, .flags = SIMTEMP_FLAG_NEW_SAMPLE };
+    struct simtemp_sample out;
+    unsigned int ops = 0, got, i;
+    u64 t0, ns = 0;
+
+    while (ops < SIMTEMP_KUNIT_BENCH_OPS) {
+        while (simtemp_ring_push(&simdev->ring, &s))
+            ;
+
+        got = 0;
+        t0 = ktime_get_ns();
+        for (i = 0; i < SIMTEMP_BUFFER_SIZE; i++)
+            got += simtemp_kunit_drain(simdev, &out, 1);
+        ns += ktime_get_ns() - t0;
+        ops += SIMTEMP_BUFFER_SIZE;
+
+        KUNIT_ASSERT_EQ(test, got, (unsigned int)SIMTEMP_BUFFER_SIZE);
+        cond_resched();
+    }
+    simtemp_kunit_report(test, "read-path dequeue", ns, ops);
+}
+
+// Whole timer callback per generator mode, single channel and 8-channel
+// frames. Includes mod_timer() and the idle netlink check; the threshold
+// is out of reach so the alert printk does not dominate.
+static void simtemp_bench_timer_callback(struct kunit *test)
+{
+    static const unsigned int widths[] = { 1, 8 };
+    struct simtemp_dev *simdev = ((struct simtemp_kunit_ctx *)test->priv)->simdev;
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    unsigned int mode, w, ops, i;
+    char what[32];
+    u64 t0, ns;
+
+    simtemp_set_threshold_locked(simdev, 0);
+
+    for (w = 0; w < ARRAY_SIZE(widths); w++) {
+        for (mode = SIMTEMP_MODE_NORMAL; mode <= SIMTEMP_MODE_RAMP; mode++) {
+            simdev->mode = mode;
+            simdev->channels = widths[w];
+
+            for (ops = 0, ns = 0; ops < SIMTEMP_KUNIT_BENCH_OPS; ops += SIMTEMP_BUFFER_SIZE) {
+                t0 = ktime_get_ns();
+                for (i = 0; i < SIMTEMP_BUFFER_SIZE; i++)
+                    simtemp_kunit_tick(simdev);
+                ns += ktime_get_ns() - t0;
+
+                simtemp_kunit_drain(simdev, out, SIMTEMP_BUFFER_SIZE);
+                spin_lock_bh(&simdev->lock);
+                simdev->frames.head = simdev->frames.tail = simdev->frames.count = 0;
+                spin_unlock_bh(&simdev->lock);
+                cond_resched();
+            }
+
+            snprintf(what, sizeof(what), "tick %s x%u", simtemp_kunit_modes[mode], widths[w]);
+            simtemp_kunit_report(test, what, ns, ops);
+        }
+    }
+    KUNIT_EXPECT_EQ(test, simdev->stats.alerts_triggered, 0ULL);
+}
+
+static struct kunit_case simtemp_kunit_cases[] = {
+    KUNIT_CASE(simtemp_test_ring_wraparound),
+    KUNIT_CASE(simtemp_test_history_window),
+    KUNIT_CASE(simtemp_test_frame_ring_wraparound),
+    KUNIT_CASE(simtemp_test_ring_overflow),
+    KUNIT_CASE(simtemp_test_producer_consumer),
+    KUNIT_CASE(simtemp_test_threshold_edges),
+    KUNIT_CASE(simtemp_test_threshold_timer),
+    KUNIT_CASE(simtemp_test_threshold_channels),
+    KUNIT_CASE(simtemp_test_adaptive_period),
+    KUNIT_CASE(simtemp_test_adaptive_noise),
+    KUNIT_CASE(simtemp_test_config_during_sampling),
+    KUNIT_CASE(simtemp_bench_enqueue),
+    KUNIT_CASE(simtemp_bench_dequeue),
+    KUNIT_CASE(simtemp_bench_timer_callback),
+    {}
+};
+
+static struct kunit_suite simtemp_kunit_suite = {
+    .name = "simtemp",
+    .init = simtemp_kunit_init,
+    .exit = simtemp_kunit_exit,
+    .test_cases = simtemp_kunit_cases,
+};
+kunit_test_suite(simtemp_kunit_suite);
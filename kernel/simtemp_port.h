@@ -0,0 +1,95 @@
+#ifndef SIMTEMP_PORT_H
+#define SIMTEMP_PORT_H
+
+//
+// Portability shim for simtemp_core.c. The same source is built into
+// nxp_simtemp.ko and into the userspace library user/core/libsimtemp_core.a,
+// so the core only uses the few kernel facilities mapped here.
+//
+// Userspace mapping:
+//   u32/s32/u64/s64, S64_MAX     <- <linux/types.h>, <stdint.h>
+//   min_t/max_t/clamp_t          <- plain macros (no type checking)
+//   get_random_u32()             <- xorshift32 (user/core/simtemp_port_user.c)
+//   ktime_get_ns()               <- clock_gettime(CLOCK_MONOTONIC)
+//   spinlock_t, spin_lock[_bh]() <- test-and-set spinlock (no softirqs here)
+//
+
+#ifdef __KERNEL__
+
+#include <linux/types.h>
+#include <linux/kernel.h>      // For min_t(), max_t(), clamp_t()
+#include <linux/limits.h>      // For S64_MAX
+#include <linux/string.h>      // For memcpy()
+#include <linux/random.h>      // For get_random_u32()
+#include <linux/ktime.h>       // For ktime_get_ns()
+#include <linux/spinlock.h>
+
+#else // userspace
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <linux/types.h>
+
+typedef __u32 u32;
+typedef __s32 s32;
+typedef __u64 u64;
+typedef __s64 s64;
+
+#ifndef S64_MAX
+#define S64_MAX INT64_MAX
+#endif
+
+#define min_t(type, a, b) ((type)(a) < (type)(b) ? (type)(a) : (type)(b))
+#define max_t(type, a, b) ((type)(a) > (type)(b) ? (type)(a) : (type)(b))
+#define clamp_t(type, v, lo, hi) min_t(type, max_t(type, v, lo), hi)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-thread xorshift32; simtemp_port_seed() makes runs reproducible
+u32 get_random_u32(void);
+void simtemp_port_seed(u32 seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline u64 ktime_get_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+typedef struct {
+    int locked;
+} spinlock_t;
+
+static inline void spin_lock_init(spinlock_t *lock)
+{
+    lock->locked = 0;
+}
+
+static inline void spin_lock(spinlock_t *lock)
+{
+    while (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(&lock->locked, __ATOMIC_RELAXED))
+            ;
+}
+
+static inline void spin_unlock(spinlock_t *lock)
+{
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
+// No bottom halves in userspace: _bh is the plain lock
+#define spin_lock_bh(lock)   spin_lock(lock)
+#define spin_unlock_bh(lock) spin_unlock(lock)
+
+#endif // __KERNEL__
+
+#endif // SIMTEMP_PORT_H
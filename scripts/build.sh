@@ -17,6 +17,9 @@ set -e # Exit if any command fails
 
 KERNEL_DIR="../kernel"
 USER_DIR="../user"
+DAEMON_DIR="../user/daemon"
+RECORDER_DIR="../user/recorder"
+CORE_DIR="../user/core"
 PY_REQ="../cli/requirements.txt"
 VENV_DIR="../user/.venv"
 
@@ -29,6 +32,15 @@ echo "=========================================="
 if [ "$1" == "clean" ]; then
     echo "--- Cleaning Kernel Module ---"
     (cd "$KERNEL_DIR" && make clean)
+
+    echo "--- Cleaning Fan-out Daemon ---"
+    (cd "$DAEMON_DIR" && make clean)
+
+    echo "--- Cleaning Recorder ---"
+    (cd "$RECORDER_DIR" && make clean)
+
+    echo "--- Cleaning Userspace Core Library ---"
+    (cd "$CORE_DIR" && make clean)
     
     echo "--- Cleaning Python Virtual Environment ---"
     if [ -d "$VENV_DIR" ]; then
@@ -56,6 +68,18 @@ fi
 
 (cd "$KERNEL_DIR" && make "$@")
 
+echo ""
+echo "--- Building Fan-out Daemon (simtempd + client library) ---"
+(cd "$DAEMON_DIR" && make)
+
+echo ""
+echo "--- Building Recorder (simtemp_rec) ---"
+(cd "$RECORDER_DIR" && make)
+
+echo ""
+echo "--- Building Userspace Core Library (libsimtemp_core.a + fuzz target) ---"
+# The benchmark needs libbenchmark-dev: make -C user/core bench
+(cd "$CORE_DIR" && make libsimtemp_core.a simtemp_core_fuzz)
 
 
 echo ""
@@ -95,6 +119,9 @@ echo ""
 echo "--- Build complete ---"
 echo "Kernel module: $KERNEL_DIR/nxp_simtemp.ko"
 echo "User apps:     $USER_DIR/cli/main.py, $USER_DIR/gui/gui.py"
+echo "Daemon:        $DAEMON_DIR/simtempd"
+echo "Recorder:      $RECORDER_DIR/simtemp_rec"
+echo "Core library:  $CORE_DIR/libsimtemp_core.a"
 echo "Python venv:   $VENV_DIR"
 echo ""
 echo "To run CLI:    $VENV_DIR/bin/python3 $USER_DIR/cli/main.py"
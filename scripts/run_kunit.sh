@@ -0,0 +1,46 @@
+#!/bin/bash
+#
+# run_kunit.sh - Run the nxp_simtemp KUnit suite under UML (no hardware, no root).
+#
+#   bash run_kunit.sh <kernel source tree> [extra kunit.py args, e.g. --arch=x86_64]
+#
+# The kernel tree is never modified: it is cloned into a scratch directory
+# (hard links when on the same filesystem, so this is cheap), kernel/ is
+# copied in as drivers/misc/simtemp, the Kconfig/Makefile glue is added to
+# the clone only, and tools/testing/kunit/kunit.py runs there with
+# kernel/.kunitconfig. The scratch directory is removed on exit.
+#
+set -e # Exit if any command fails
+
+if [ -z "$1" ] || [ ! -x "$1/tools/testing/kunit/kunit.py" ]; then
+    echo "Usage: $0 <kernel source tree> [kunit.py args]"
+    exit 1
+fi
+
+KSRC=$(cd -- "$1" && pwd)
+shift
+KERNEL_DIR=$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")/../kernel" && pwd)
+
+SCRATCH=$(mktemp -d "${TMPDIR:-/tmp}/simtemp-kunit.XXXXXX")
+trap 'rm -rf "$SCRATCH"' EXIT
+TREE="$SCRATCH/linux"
+MISC_DIR="$TREE/drivers/misc"
+
+echo "--- Cloning $KSRC into $TREE ---"
+cp -al "$KSRC" "$TREE" 2>/dev/null || { rm -rf "$TREE"; cp -a "$KSRC" "$TREE"; }
+
+# Files in a hard-linked clone share storage with the original, so edits
+# below always write a new file and rename it over the link, never in place
+echo "--- Adding driver as drivers/misc/simtemp ---"
+rm -rf "$MISC_DIR/simtemp"
+cp -a "$KERNEL_DIR" "$MISC_DIR/simtemp"
+
+sed '$i source "drivers/misc/simtemp/Kconfig"' "$MISC_DIR/Kconfig" > "$MISC_DIR/Kconfig.new"
+mv -f "$MISC_DIR/Kconfig.new" "$MISC_DIR/Kconfig"
+{ cat "$MISC_DIR/Makefile"; echo 'obj-$(CONFIG_NXP_SIMTEMP)	+= simtemp/'; } > "$MISC_DIR/Makefile.new"
+mv -f "$MISC_DIR/Makefile.new" "$MISC_DIR/Makefile"
+
+echo "--- Running KUnit suite 'simtemp' ---"
+cd "$TREE"
+./tools/testing/kunit/kunit.py run --kunitconfig=drivers/misc/simtemp \
+    --build_dir="$SCRATCH/build" "$@" 'simtemp'
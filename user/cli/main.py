@@ -1,13 +1,19 @@
 #!/usr/bin/env python3
 
 import os
+import ctypes
 import fcntl
+import socket
 import struct
 import select
 import sys
 import argparse
 import time
 from datetime import datetime
+from pathlib import Path
+
+# simtempd client (user/daemon), used by --via-daemon
+DAEMON_DIR = Path(__file__).resolve().parent.parent / "daemon"
 
 # Define the binary structure (must match nxp_simtemp_ioctl.h!)
 # __u64 timestamp_ns -> 'Q' (unsigned long long, 8 bytes)
@@ -20,10 +26,83 @@ STRUCT_SIZE = struct.calcsize(STRUCT_FORMAT)
 SIMTEMP_FLAG_NEW_SAMPLE = (1 << 0)
 SIMTEMP_FLAG_THRESHOLD_CROSSED = (1 << 1)
 
+# ioctl numbers (must match nxp_simtemp_ioctl.h!)
+# struct simtemp_batch { __u64 samples; __u32 max_samples; __u32 count; }
+BATCH_FORMAT = 'Q I I'
+BATCH_SIZE = struct.calcsize(BATCH_FORMAT)
+SIMTEMP_IOC_MAGIC = ord('p')
+SIMTEMP_HISTORY_SIZE = 1024
+
+def _IOC(direction, nr, size):
+    """Linux _IOC() encoding: dir(2) | size(14) | type(8) | nr(8)."""
+    return (direction << 30) | (size << 16) | (SIMTEMP_IOC_MAGIC << 8) | nr
+
+def _IOWR(nr, size):
+    return _IOC(3, nr, size)
+
+SIMTEMP_IOC_GET_HISTORY = _IOWR(4, BATCH_SIZE)
+
+# struct simtemp_adaptive { __u32 policy, min_ms, max_ms, step_ms; __s32 band_mC, slope_mC; }
+ADAPTIVE_FORMAT = 'I I I I i i'
+ADAPTIVE_SIZE = struct.calcsize(ADAPTIVE_FORMAT)
+ADAPTIVE_POLICIES = ['off', 'jump', 'halve']   # enum simtemp_adaptive_policy order
+SIMTEMP_IOC_SET_ADAPTIVE = _IOC(1, 5, ADAPTIVE_SIZE)  # _IOW
+SIMTEMP_IOC_GET_ADAPTIVE = _IOC(2, 6, ADAPTIVE_SIZE)  # _IOR
+
+# Multi-channel frame layout (must match nxp_simtemp_ioctl.h!)
+# struct simtemp_frame_hdr { __u32 channels; __u32 nframes; } followed by
+# __u64 timestamp_ns[n], __u32 alert_mask[n], __s32 temp_mC[channels][n]
+FRAME_HDR_FORMAT = 'I I'
+FRAME_HDR_SIZE = struct.calcsize(FRAME_HDR_FORMAT)
+SIMTEMP_MAX_CHANNELS = 32
+SIMTEMP_FRAME_RING_SIZE = 64
+
+def frame_bytes(channels, nframes):
+    """Size of a read() holding nframes frames (SIMTEMP_FRAME_BYTES)."""
+    return FRAME_HDR_SIZE + nframes * (8 + 4 + 4 * channels)
+
+def decode_frames(data):
+    """Decode a struct-of-arrays frame batch into (timestamps, masks, per-channel temps)."""
+    channels, nframes = struct.unpack_from(FRAME_HDR_FORMAT, data)
+    off = FRAME_HDR_SIZE
+    timestamps = struct.unpack_from(f'{nframes}Q', data, off)
+    off += 8 * nframes
+    masks = struct.unpack_from(f'{nframes}I', data, off)
+    off += 4 * nframes
+    temps = [struct.unpack_from(f'{nframes}i', data, off + 4 * nframes * ch) for ch in range(channels)]
+    return timestamps, masks, temps
+
 # Sysfs paths (assuming it's mounted at /sys/class/simtemp/simtemp)
 SYSFS_PATH = "/sys/class/simtemp/simtemp"
 DEVICE_PATH = "/dev/simtemp"
 
+# Generic netlink (must match nxp_simtemp_netlink.h!)
+SIMTEMP_NL_FAMILY_NAME = "simtemp"
+SIMTEMP_NL_MCGRP_NAME = "events"
+SIMTEMP_NL_CMD_THRESHOLD_EVENT = 1
+SIMTEMP_NL_CMD_AGGREGATE = 2
+SIMTEMP_NL_ATTRS = {
+    2: ('dev_id', 'I'), 3: ('dev_name', 's'), 4: ('timestamp_ns', 'Q'),
+    5: ('temp_mC', 'i'), 6: ('threshold_mC', 'i'), 7: ('first_ts_ns', 'Q'),
+    8: ('count', 'I'), 9: ('min_mC', 'i'), 10: ('max_mC', 'i'),
+    11: ('mean_mC', 'i'), 12: ('alerts', 'I'), 13: ('channel', 'I'),
+}
+
+# Netlink/genetlink constants (from linux/netlink.h, linux/genetlink.h)
+NETLINK_GENERIC = 16
+SOL_NETLINK = 270
+NETLINK_ADD_MEMBERSHIP = 1
+NLMSG_ERROR = 2
+NLM_F_REQUEST = 1
+GENL_ID_CTRL = 0x10
+CTRL_CMD_GETFAMILY = 3
+CTRL_ATTR_FAMILY_ID = 1
+CTRL_ATTR_FAMILY_NAME = 2
+CTRL_ATTR_MCAST_GROUPS = 7
+CTRL_ATTR_MCAST_GRP_NAME = 1
+CTRL_ATTR_MCAST_GRP_ID = 2
+NLA_TYPE_MASK = 0x3fff
+
 def sysfs_write(attr, value):
     """Write a value to a sysfs attribute."""
     path = os.path.join(SYSFS_PATH, attr)
@@ -46,8 +125,221 @@ def sysfs_read(attr):
         print(f"Error reading from sysfs {path}: {e}", file=sys.stderr)
         sys.exit(1)
 
+def nl_parse_attrs(data):
+    """Parse a flat netlink attribute stream into {type: payload}."""
+    attrs = {}
+    off = 0
+    while off + 4 <= len(data):
+        nla_len, nla_type = struct.unpack_from('HH', data, off)
+        if nla_len < 4:
+            break
+        attrs[nla_type & NLA_TYPE_MASK] = data[off + 4:off + nla_len]
+        off += (nla_len + 3) & ~3 # NLA_ALIGN
+    return attrs
+
+def nl_messages(data):
+    """Yield (nlmsg_type, payload) for every message in a netlink datagram."""
+    off = 0
+    while off + 16 <= len(data):
+        msg_len, msg_type, _, _, _ = struct.unpack_from('IHHII', data, off)
+        if msg_len < 16:
+            break
+        yield msg_type, data[off + 16:off + msg_len]
+        off += (msg_len + 3) & ~3 # NLMSG_ALIGN
+
+def nl_resolve_family(sock):
+    """Ask the genetlink controller for the simtemp family id and group id."""
+    name = SIMTEMP_NL_FAMILY_NAME.encode() + b'\0'
+    attr = struct.pack('HH', 4 + len(name), CTRL_ATTR_FAMILY_NAME) + name
+    attr += b'\0' * (((len(attr) + 3) & ~3) - len(attr))
+    payload = struct.pack('BBH', CTRL_CMD_GETFAMILY, 1, 0) + attr
+    sock.send(struct.pack('IHHII', 16 + len(payload), GENL_ID_CTRL, NLM_F_REQUEST, 1, 0) + payload)
+
+    for msg_type, msg in nl_messages(sock.recv(65536)):
+        if msg_type == NLMSG_ERROR:
+            err = -struct.unpack_from('i', msg)[0]
+            raise OSError(err, f"genetlink family '{SIMTEMP_NL_FAMILY_NAME}' not found (module loaded?)")
+        attrs = nl_parse_attrs(msg[4:]) # skip genlmsghdr
+        family_id = struct.unpack('H', attrs[CTRL_ATTR_FAMILY_ID][:2])[0]
+        # Mcast groups are a nested array of nested (name, id) entries
+        for grp in nl_parse_attrs(attrs.get(CTRL_ATTR_MCAST_GROUPS, b'')).values():
+            grp_attrs = nl_parse_attrs(grp)
+            if grp_attrs[CTRL_ATTR_MCAST_GRP_NAME].rstrip(b'\0').decode() == SIMTEMP_NL_MCGRP_NAME:
+                return family_id, struct.unpack('I', grp_attrs[CTRL_ATTR_MCAST_GRP_ID])[0]
+    raise OSError(f"multicast group '{SIMTEMP_NL_MCGRP_NAME}' not found")
+
+def nl_decode(msg):
+    """Decode a simtemp genetlink message into (cmd, {name: value})."""
+    cmd = msg[0]
+    fields = {}
+    for nla_type, payload in nl_parse_attrs(msg[4:]).items():
+        if nla_type not in SIMTEMP_NL_ATTRS:
+            continue # Unknown attribute (newer kernel), ignore
+        name, fmt = SIMTEMP_NL_ATTRS[nla_type]
+        if fmt == 's':
+            fields[name] = payload.rstrip(b'\0').decode()
+        else:
+            fields[name] = struct.unpack(fmt, payload[:struct.calcsize(fmt)])[0]
+    return cmd, fields
+
+def run_netlink_listener():
+    """Subscribe to the simtemp multicast group (no /dev/simtemp needed)."""
+    try:
+        sock = socket.socket(socket.AF_NETLINK, socket.SOCK_RAW, NETLINK_GENERIC)
+        sock.bind((0, 0))
+        family_id, group_id = nl_resolve_family(sock)
+        sock.setsockopt(SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, group_id)
+    except OSError as e:
+        print(f"Error subscribing to netlink: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    print(f"Listening on genetlink '{SIMTEMP_NL_FAMILY_NAME}/{SIMTEMP_NL_MCGRP_NAME}' "
+          f"(family={family_id}, group={group_id})...")
+    try:
+        while True:
+            for msg_type, msg in nl_messages(sock.recv(65536)):
+                if msg_type != family_id:
+                    continue
+                cmd, f = nl_decode(msg)
+                ts_iso = datetime.fromtimestamp(f.get('timestamp_ns', 0) / 1e9).isoformat(timespec='milliseconds')
+                dev = f"{f.get('dev_name', '?')}({f.get('dev_id', 0):#x})"
+                if 'channel' in f:
+                    dev += f"[ch{f['channel']}]"
+                if cmd == SIMTEMP_NL_CMD_THRESHOLD_EVENT:
+                    print(f"{ts_iso} | {dev} | ALERT temp={f['temp_mC'] / 1000.0:.3f} C "
+                          f"thr={f['threshold_mC'] / 1000.0:.3f} C")
+                elif cmd == SIMTEMP_NL_CMD_AGGREGATE:
+                    print(f"{ts_iso} | {dev} | AGG n={f['count']} min={f['min_mC'] / 1000.0:.3f} "
+                          f"max={f['max_mC'] / 1000.0:.3f} mean={f['mean_mC'] / 1000.0:.3f} alerts={f['alerts']}")
+    except KeyboardInterrupt:
+        print("\nListening stopped by user.")
+    finally:
+        sock.close()
+
+def run_frame_monitor(dev_fd, channels):
+    """Monitoring loop for multi-channel mode (SoA frame batches)."""
+    read_size = frame_bytes(channels, SIMTEMP_FRAME_RING_SIZE)
+    print(f"Monitoring {DEVICE_PATH} ({channels} channels, up to {read_size} bytes per read)...")
+    print("Timestamp (ISO)         | Alert mask | Temps (C)")
+    print("-" * 50)
+
+    poller = select.poll()
+    poller.register(dev_fd, select.POLLIN | select.POLLRDNORM | select.POLLPRI)
+
+    while True:
+        try:
+            for fd, event in poller.poll():
+                if event & select.POLLPRI:
+                    print(f"!!! THRESHOLD EVENT (POLLPRI) RECEIVED !!!")
+
+                if event & (select.POLLIN | select.POLLRDNORM):
+                    # One read drains every queued frame
+                    binary_data = os.read(dev_fd, read_size)
+                    if len(binary_data) == 0:
+                        print("End of file (Is the module unloaded?). Exiting.")
+                        return
+
+                    timestamps, masks, temps = decode_frames(binary_data)
+                    for i, ts in enumerate(timestamps):
+                        ts_iso = datetime.fromtimestamp(ts / 1e9).isoformat(timespec='milliseconds')
+                        row = " ".join(f"{temps[ch][i] / 1000.0:6.3f}" for ch in range(len(temps)))
+                        print(f"{ts_iso} | {masks[i]:#010x} | {row}")
+
+        except KeyboardInterrupt:
+            print("\nMonitoring stopped by user.")
+            break
+        except Exception as e:
+            print(f"Error in poll loop: {e}", file=sys.stderr)
+            break
+
+def run_history(count):
+    """Print the last 'count' samples without consuming them (SIMTEMP_IOC_GET_HISTORY)."""
+    count = max(1, min(count, SIMTEMP_HISTORY_SIZE))
+    samples = ctypes.create_string_buffer(count * STRUCT_SIZE)
+    batch = bytearray(struct.pack(BATCH_FORMAT, ctypes.addressof(samples), count, 0))
+
+    try:
+        fd = os.open(DEVICE_PATH, os.O_RDONLY | os.O_NONBLOCK)
+        try:
+            fcntl.ioctl(fd, SIMTEMP_IOC_GET_HISTORY, batch, True)
+        finally:
+            os.close(fd)
+    except OSError as e:
+        print(f"Error reading history from {DEVICE_PATH}: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    _, _, returned = struct.unpack(BATCH_FORMAT, batch)
+    print(f"Last {returned} samples (oldest first):")
+    print("Timestamp (ISO)         | Temp (C) | Alert")
+    print("-" * 50)
+    for timestamp, temp, flags in struct.iter_unpack(STRUCT_FORMAT, samples.raw[:returned * STRUCT_SIZE]):
+        ts_iso = datetime.fromtimestamp(timestamp / 1e9).isoformat(timespec='milliseconds')
+        print(f"{ts_iso} | {temp / 1000.0:8.3f} | {bool(flags & SIMTEMP_FLAG_THRESHOLD_CROSSED)}")
+
+def set_adaptive(policy, period_range):
+    """Update the adaptive sampling policy and/or MIN:MAX range in one ioctl,
+    so the driver never sees a transient min > max."""
+    try:
+        fd = os.open(DEVICE_PATH, os.O_RDONLY | os.O_NONBLOCK)
+        try:
+            cfg = bytearray(ADAPTIVE_SIZE)
+            fcntl.ioctl(fd, SIMTEMP_IOC_GET_ADAPTIVE, cfg, True)
+            fields = list(struct.unpack(ADAPTIVE_FORMAT, cfg))
+            if policy is not None:
+                fields[0] = ADAPTIVE_POLICIES.index(policy)
+            if period_range is not None:
+                fields[1], fields[2] = period_range
+            fcntl.ioctl(fd, SIMTEMP_IOC_SET_ADAPTIVE, struct.pack(ADAPTIVE_FORMAT, *fields))
+        finally:
+            os.close(fd)
+    except OSError as e:
+        print(f"Error setting adaptive sampling on {DEVICE_PATH}: {e}", file=sys.stderr)
+        sys.exit(1)
+
+def parse_range(text):
+    """'MIN:MAX' in ms -> (min, max)."""
+    try:
+        lo, hi = (int(v) for v in text.split(':'))
+    except ValueError:
+        raise argparse.ArgumentTypeError("expected MIN:MAX in ms, e.g. 10:1000")
+    return lo, hi
+
+def run_daemon_monitor():
+    """Monitoring loop fed by simtempd (shared-memory ring, no /dev/simtemp fd)."""
+    sys.path.append(str(DAEMON_DIR))
+    try:
+        from simtemp_client import SimtempClient
+        client = SimtempClient()
+    except (ImportError, OSError) as e:
+        print(f"Error attaching to simtempd: {e}", file=sys.stderr)
+        print(f"Build it with 'make -C {DAEMON_DIR}' and start simtempd first.", file=sys.stderr)
+        sys.exit(1)
+
+    print("Monitoring via simtempd (shared memory)...")
+    print("Timestamp (ISO)         | Temp (C) | Alert")
+    print("-" * 50)
+
+    with client:
+        try:
+            while True:
+                # Finite timeout, like the GUI, so Ctrl+C and a dead daemon are noticed
+                for timestamp, temp, flags in client.read(1000):
+                    ts_iso = datetime.fromtimestamp(timestamp / 1e9).isoformat(timespec='milliseconds')
+                    alert_flag = bool(flags & SIMTEMP_FLAG_THRESHOLD_CROSSED)
+                    print(f"{ts_iso} | {temp / 1000.0:8.3f} | {alert_flag}")
+        except KeyboardInterrupt:
+            print("\nMonitoring stopped by user.")
+        except EOFError:
+            print("simtempd exited. Exiting.")
+        if client.overruns:
+            print(f"Lost {client.overruns} samples (client too slow)", file=sys.stderr)
+
 def run_monitor(dev_fd):
     """Main monitoring loop using poll."""
+    channels = int(sysfs_read("channels"))
+    if channels > 1:
+        return run_frame_monitor(dev_fd, channels)
+
     print(f"Monitoring {DEVICE_PATH} (struct size={STRUCT_SIZE} bytes)...")
     print("Timestamp (ISO)         | Temp (C) | Alert")
     print("-" * 50)
@@ -192,6 +484,46 @@ def main():
         choices=['normal', 'noisy', 'ramp'],
         help="Set the simulation mode via sysfs"
     )
+    parser.add_argument(
+        '-l', '--listen',
+        action='store_true',
+        help="Subscribe to threshold events/aggregates over generic netlink"
+    )
+    parser.add_argument(
+        '-a', '--set-aggregate',
+        type=int,
+        metavar="N",
+        help="Publish a netlink aggregate every N samples via sysfs (0 = off)"
+    )
+    parser.add_argument(
+        '-c', '--set-channels',
+        type=int,
+        metavar="N",
+        help=f"Set the channel count via sysfs (1 = single records, 2..{SIMTEMP_MAX_CHANNELS} = SoA frames)"
+    )
+    parser.add_argument(
+        '--via-daemon',
+        action='store_true',
+        help="Read samples from the simtempd shared-memory ring instead of /dev/simtemp "
+             "(single-channel mode only: simtempd pauses while channels > 1)"
+    )
+    parser.add_argument(
+        '--set-adaptive',
+        choices=ADAPTIVE_POLICIES,
+        help="Adaptive sampling policy: off (fixed sampling_ms), jump or halve near the threshold"
+    )
+    parser.add_argument(
+        '--adaptive-range',
+        type=parse_range,
+        metavar="MIN:MAX",
+        help="Adaptive sampling period bounds in ms (e.g. 10:1000)"
+    )
+    parser.add_argument(
+        '-H', '--history',
+        type=int,
+        metavar="N",
+        help=f"Print the last N samples (max {SIMTEMP_HISTORY_SIZE}) without consuming them"
+    )
     
     args = parser.parse_args()
 
@@ -208,14 +540,36 @@ def main():
         sysfs_write("threshold_mC", args.set_threshold_mc)
     if args.set_mode:
         sysfs_write("mode", args.set_mode)
+    if args.set_aggregate is not None:
+        sysfs_write("nl_aggregate_samples", args.set_aggregate)
+    if args.set_channels is not None:
+        sysfs_write("channels", args.set_channels)
+    if args.set_adaptive or args.adaptive_range:
+        set_adaptive(args.set_adaptive, args.adaptive_range)
+
+    # --- History Peek (non-consuming) ---
+    if args.history is not None:
+        run_history(args.history)
+        sys.exit(0)
+
+    # --- Netlink Subscriber Mode ---
+    if args.listen:
+        run_netlink_listener()
+        sys.exit(0)
 
     # If only configuration was set, don't monitor
-    if any([args.set_sampling_ms, args.set_threshold_mc, args.set_mode]):
+    if any([args.set_sampling_ms, args.set_threshold_mc, args.set_mode,
+            args.set_aggregate is not None, args.set_channels is not None,
+            args.set_adaptive, args.adaptive_range]):
         print("Configuration updated. Current stats:")
         print(sysfs_read("stats"))
         sys.exit(0)
 
     # --- Monitoring Mode (default) ---
+    if args.via_daemon:
+        run_daemon_monitor()
+        sys.exit(0)
+
     try:
         # Open the character device
         # We use os.open to get a file descriptor (int)
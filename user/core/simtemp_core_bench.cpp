@@ -0,0 +1,257 @@
+//
+// simtemp_core_bench - Google Benchmark microbenchmarks for the driver core
+// (kernel/simtemp_core.c built as libsimtemp_core.a). No module, no root.
+//
+//   make bench                           -> all benchmarks
+//   ./simtemp_core_bench --benchmark_filter=Ring
+//   perf record ./simtemp_core_bench --benchmark_filter=Tick
+//
+// Locked variants take the simtemp_port.h spinlock the way the driver takes
+// dev->lock, so the difference to the unlocked variant is the lock cost.
+//
+
+#include <benchmark/benchmark.h>
+
+#include "simtemp_core.h"
+
+namespace {
+
+const char *const kModeNames[] = {"normal", "noisy", "ramp"};
+
+struct simtemp_sample make_sample(u64 seq)
+{
+    struct simtemp_sample s;
+
+    s.timestamp_ns = seq;
+    s.temp_mC = 25000 + int(seq % 10000);
+    s.flags = SIMTEMP_FLAG_NEW_SAMPLE;
+    return s;
+}
+
+// Steady state: one push, one pop (timer + read() for a keeping-up reader)
+void BM_RingPushPop(benchmark::State &state)
+{
+    struct simtemp_ring ring = {};
+    struct simtemp_sample out;
+    u64 seq = 0;
+
+    for (auto _ : state) {
+        struct simtemp_sample s = make_sample(seq++);
+        simtemp_ring_push(&ring, &s);
+        benchmark::DoNotOptimize(simtemp_ring_pop(&ring, &out, 1));
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RingPushPop);
+
+void BM_RingPushPopLocked(benchmark::State &state)
+{
+    struct simtemp_ring ring = {};
+    struct simtemp_sample out;
+    spinlock_t lock;
+    u64 seq = 0;
+
+    spin_lock_init(&lock);
+    for (auto _ : state) {
+        struct simtemp_sample s = make_sample(seq++);
+
+        spin_lock(&lock);
+        simtemp_ring_push(&ring, &s);
+        spin_unlock(&lock);
+
+        spin_lock_bh(&lock);
+        benchmark::DoNotOptimize(simtemp_ring_pop(&ring, &out, 1));
+        spin_unlock_bh(&lock);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RingPushPopLocked);
+
+// Full ring drained N records per call (read() = 1, READ_BATCH = up to 16)
+void BM_RingBatchDrain(benchmark::State &state)
+{
+    const unsigned int batch = state.range(0);
+    struct simtemp_ring ring = {};
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    u64 seq = 0;
+
+    for (auto _ : state) {
+        for (int i = 0; i < SIMTEMP_BUFFER_SIZE; i++) {
+            struct simtemp_sample s = make_sample(seq++);
+            simtemp_ring_push(&ring, &s);
+        }
+        while (simtemp_ring_pop(&ring, out, batch))
+            benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * SIMTEMP_BUFFER_SIZE);
+}
+BENCHMARK(BM_RingBatchDrain)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_HistoryPush(benchmark::State &state)
+{
+    static struct simtemp_history hist;
+    u64 seq = 0;
+
+    for (auto _ : state) {
+        struct simtemp_sample s = make_sample(seq++);
+        simtemp_history_push(&hist, &s);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistoryPush);
+
+// SIMTEMP_IOC_GET_HISTORY snapshot of the newest N entries (wrapped ring)
+void BM_HistoryPeek(benchmark::State &state)
+{
+    static struct simtemp_history hist;
+    static struct simtemp_sample out[SIMTEMP_HISTORY_SIZE];
+    const unsigned int n = state.range(0);
+
+    for (u64 seq = 0; seq < SIMTEMP_HISTORY_SIZE + SIMTEMP_HISTORY_SIZE / 2; seq++) {
+        struct simtemp_sample s = make_sample(seq);
+        simtemp_history_push(&hist, &s);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simtemp_history_peek(&hist, out, n));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_HistoryPeek)->Arg(1)->Arg(64)->Arg(SIMTEMP_HISTORY_SIZE);
+
+// Multi-channel: one frame in, one frame out (SoA copy), per channel count
+void BM_FramePushPop(benchmark::State &state)
+{
+    static struct simtemp_frame_ring fr;
+    const unsigned int channels = state.range(0);
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    s32 out_temps[SIMTEMP_MAX_CHANNELS];
+    u64 ts;
+    u32 mask;
+
+    for (unsigned int ch = 0; ch < channels; ch++)
+        temps[ch] = 25000 + ch;
+
+    for (auto _ : state) {
+        simtemp_frame_ring_push(&fr, 1, 0, temps, channels);
+        benchmark::DoNotOptimize(simtemp_frame_ring_pop(&fr, channels, 1, &ts, &mask, out_temps));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * channels);
+}
+BENCHMARK(BM_FramePushPop)->Arg(2)->Arg(8)->Arg(32);
+
+// Generator cost per mode (normal/noisy draw a random number, ramp does not)
+void BM_Generate(benchmark::State &state)
+{
+    const auto mode = static_cast<enum simtemp_mode>(state.range(0));
+    u64 seq = 0;
+
+    state.SetLabel(kModeNames[state.range(0)]);
+    simtemp_port_seed(1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simtemp_generate_temp(mode, seq++, 0));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Generate)->DenseRange(SIMTEMP_MODE_NORMAL, SIMTEMP_MODE_RAMP);
+
+// Branch-free threshold mask over N channels
+void BM_ThresholdMask(benchmark::State &state)
+{
+    const unsigned int n = state.range(0);
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+
+    simtemp_port_seed(1);
+    for (unsigned int ch = 0; ch < n; ch++) {
+        temps[ch] = simtemp_generate_temp(SIMTEMP_MODE_NOISY, 0, ch);
+        thresholds[ch] = 30000;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(temps);
+        benchmark::DoNotOptimize(simtemp_threshold_mask(temps, thresholds, n));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ThresholdMask)->Arg(1)->Arg(8)->Arg(32);
+
+void BM_AdaptiveNext(benchmark::State &state)
+{
+    const struct simtemp_adaptive cfg = {SIMTEMP_ADAPTIVE_HALVE, 10, 1000, 50, 2000, 1000};
+    const unsigned int n = state.range(0);
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+    s32 avg[SIMTEMP_MAX_CHANNELS] = {};
+    unsigned int period = 100;
+    u64 seq = 0;
+
+    for (unsigned int ch = 0; ch < n; ch++)
+        thresholds[ch] = 30000;
+
+    for (auto _ : state) {
+        for (unsigned int ch = 0; ch < n; ch++)
+            temps[ch] = simtemp_generate_temp(SIMTEMP_MODE_RAMP, seq, ch);
+        period = simtemp_adaptive_next(&cfg, period, avg, temps, thresholds, n);
+        benchmark::DoNotOptimize(period);
+        seq += 97;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AdaptiveNext)->Arg(1)->Arg(32);
+
+// The single-channel timer callback body, minus wakeups/netlink/mod_timer:
+// lock, generate, threshold edge, history, delivery ring, adaptive period.
+// The ring is drained every SIMTEMP_BUFFER_SIZE ticks like a batch reader.
+void BM_Tick(benchmark::State &state)
+{
+    static struct simtemp_ring ring;
+    static struct simtemp_history hist;
+    const auto mode = static_cast<enum simtemp_mode>(state.range(0));
+    const struct simtemp_adaptive cfg = {SIMTEMP_ADAPTIVE_OFF, 10, 1000, 50, 2000, 1000};
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE];
+    s32 threshold = 30000;
+    s32 avg = 0;
+    bool flag = false;
+    u64 generated = 0;
+    spinlock_t lock;
+
+    state.SetLabel(kModeNames[state.range(0)]);
+    simtemp_port_seed(1);
+    spin_lock_init(&lock);
+
+    for (auto _ : state) {
+        struct simtemp_sample s;
+        s32 temp;
+
+        spin_lock(&lock);
+        temp = simtemp_generate_temp(mode, generated, 0);
+        s.temp_mC = temp;
+        s.flags = SIMTEMP_FLAG_NEW_SAMPLE;
+        if (simtemp_threshold_update(&flag, temp, threshold))
+            s.flags |= SIMTEMP_FLAG_THRESHOLD_CROSSED;
+        s.timestamp_ns = ktime_get_ns();
+        simtemp_history_push(&hist, &s);
+        benchmark::DoNotOptimize(simtemp_adaptive_next(&cfg, 100, &avg, &temp, &threshold, 1));
+        if (simtemp_ring_push(&ring, &s))
+            generated++;
+        spin_unlock(&lock);
+
+        if (ring.count == SIMTEMP_BUFFER_SIZE) {
+            spin_lock_bh(&lock);
+            simtemp_ring_pop(&ring, out, SIMTEMP_BUFFER_SIZE);
+            spin_unlock_bh(&lock);
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Tick)->DenseRange(SIMTEMP_MODE_NORMAL, SIMTEMP_MODE_RAMP);
+
+} // namespace
+
+BENCHMARK_MAIN();
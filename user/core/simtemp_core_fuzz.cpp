@@ -0,0 +1,338 @@
+//
+// simtemp_core_fuzz - fuzz target for the driver core.
+//
+// Each input byte stream is an operation script applied to the rings and to
+// the threshold/adaptive logic, checked against straightforward reference
+// models (std::deque). Any divergence or broken invariant aborts.
+//
+//   libFuzzer: clang++ -fsanitize=fuzzer,address,undefined ...  (make fuzz-libfuzzer)
+//   no clang:  built with SIMTEMP_FUZZ_STANDALONE, which adds a main() that
+//              replays files or generates random scripts            (make fuzz)
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+#include "simtemp_core.h"
+
+namespace {
+
+#define FUZZ_CHECK(cond)                                                              \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            fprintf(stderr, "simtemp_core_fuzz: %s:%d: check failed: %s\n", __FILE__, \
+                    __LINE__, #cond);                                                 \
+            abort();                                                                  \
+        }                                                                             \
+    } while (0)
+
+// Sequential reader over the fuzzer input (zeros once exhausted)
+class Input {
+public:
+    Input(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    bool empty() const { return pos_ >= size_; }
+
+    uint8_t u8() { return pos_ < size_ ? data_[pos_++] : 0; }
+
+    uint32_t u32()
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++)
+            v |= uint32_t(u8()) << (8 * i);
+        return v;
+    }
+
+    int32_t s32() { return int32_t(u32()); }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+struct Frame {
+    u64 ts;
+    u32 mask;
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+};
+
+bool same_sample(const struct simtemp_sample &a, const struct simtemp_sample &b)
+{
+    return a.timestamp_ns == b.timestamp_ns && a.temp_mC == b.temp_mC && a.flags == b.flags;
+}
+
+struct State {
+    struct simtemp_ring ring = {};
+    struct simtemp_history hist = {};
+    struct simtemp_frame_ring frames = {};
+    unsigned int channels = 1;
+
+    std::deque<struct simtemp_sample> ring_model;
+    std::deque<struct simtemp_sample> hist_model;
+    std::deque<Frame> frame_model;
+    u64 seq = 0;
+    u64 dropped = 0;
+
+    bool flag = false;
+    bool flag_model = false;
+};
+
+struct simtemp_sample next_sample(State &st, Input &in)
+{
+    struct simtemp_sample s;
+
+    s.timestamp_ns = ++st.seq;
+    s.temp_mC = in.s32();
+    s.flags = in.u8() & 3;
+    return s;
+}
+
+void op_ring_push(State &st, Input &in)
+{
+    struct simtemp_sample s = next_sample(st, in);
+    bool pushed = simtemp_ring_push(&st.ring, &s);
+
+    FUZZ_CHECK(pushed == (st.ring_model.size() < SIMTEMP_BUFFER_SIZE));
+    if (pushed)
+        st.ring_model.push_back(s);
+    else
+        st.dropped++;
+}
+
+void op_ring_pop(State &st, Input &in)
+{
+    struct simtemp_sample out[SIMTEMP_BUFFER_SIZE + 1];
+    unsigned int max = in.u8() % (SIMTEMP_BUFFER_SIZE + 2);
+    unsigned int n = simtemp_ring_pop(&st.ring, out, max);
+
+    FUZZ_CHECK(n == std::min<size_t>(max, st.ring_model.size()));
+    for (unsigned int i = 0; i < n; i++) {
+        FUZZ_CHECK(same_sample(out[i], st.ring_model.front()));
+        st.ring_model.pop_front();
+    }
+}
+
+void op_history(State &st, Input &in)
+{
+    static struct simtemp_sample out[SIMTEMP_HISTORY_SIZE + 1];
+    unsigned int pushes = in.u8() * 8;   // up to ~2 wraps per op
+    unsigned int max = in.u32() % (SIMTEMP_HISTORY_SIZE + 8);
+
+    for (unsigned int i = 0; i < pushes; i++) {
+        struct simtemp_sample s = next_sample(st, in);
+        simtemp_history_push(&st.hist, &s);
+        st.hist_model.push_back(s);
+        if (st.hist_model.size() > SIMTEMP_HISTORY_SIZE)
+            st.hist_model.pop_front();
+    }
+
+    unsigned int n = simtemp_history_peek(&st.hist, out, max);
+    FUZZ_CHECK(n == std::min<size_t>(max, st.hist_model.size()));
+    for (unsigned int i = 0; i < n; i++)
+        FUZZ_CHECK(same_sample(out[i], st.hist_model[st.hist_model.size() - n + i]));
+}
+
+void op_frames(State &st, Input &in)
+{
+    u64 ts[SIMTEMP_FRAME_RING_SIZE];
+    u32 mask[SIMTEMP_FRAME_RING_SIZE];
+    static s32 temps[SIMTEMP_MAX_CHANNELS * SIMTEMP_FRAME_RING_SIZE];
+    uint8_t cmd = in.u8();
+
+    if (cmd < 16) {
+        // Channel count change: the driver resets the frame ring
+        st.channels = 1 + in.u8() % SIMTEMP_MAX_CHANNELS;
+        st.frames.head = st.frames.tail = st.frames.count = 0;
+        st.frame_model.clear();
+    } else if (cmd < 160) {
+        Frame f;
+        f.ts = ++st.seq;
+        f.mask = in.u32();
+        for (unsigned int ch = 0; ch < st.channels; ch++)
+            f.temps[ch] = in.s32();
+
+        bool pushed = simtemp_frame_ring_push(&st.frames, f.ts, f.mask, f.temps, st.channels);
+        FUZZ_CHECK(pushed == (st.frame_model.size() < SIMTEMP_FRAME_RING_SIZE));
+        if (pushed)
+            st.frame_model.push_back(f);
+    } else {
+        unsigned int max = in.u8() % (SIMTEMP_FRAME_RING_SIZE + 4);
+        unsigned int n = simtemp_frame_ring_pop(&st.frames, st.channels, max, ts, mask, temps);
+
+        FUZZ_CHECK(n == std::min<size_t>(max, st.frame_model.size()));
+        for (unsigned int i = 0; i < n; i++) {
+            const Frame &f = st.frame_model.front();
+            FUZZ_CHECK(ts[i] == f.ts && mask[i] == f.mask);
+            for (unsigned int ch = 0; ch < st.channels; ch++)
+                FUZZ_CHECK(temps[ch * n + i] == f.temps[ch]);
+            st.frame_model.pop_front();
+        }
+    }
+    FUZZ_CHECK(st.frames.count >= 0 && st.frames.count <= SIMTEMP_FRAME_RING_SIZE);
+}
+
+void op_threshold(State &st, Input &in)
+{
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+    unsigned int n = 1 + in.u8() % SIMTEMP_MAX_CHANNELS;
+    u32 expected = 0;
+
+    // Single channel: rising edge exactly when we go from above to at/below
+    s32 temp = in.s32(), thr = in.s32();
+    bool alert = temp <= thr;
+    bool rising = simtemp_threshold_update(&st.flag, temp, thr);
+    FUZZ_CHECK(rising == (alert && !st.flag_model));
+    FUZZ_CHECK(st.flag == alert);
+    st.flag_model = alert;
+
+    // Mask form agrees with the scalar comparison on every channel
+    for (unsigned int ch = 0; ch < n; ch++) {
+        temps[ch] = in.s32();
+        thresholds[ch] = (in.u8() & 1) ? temps[ch] : in.s32();   // hit the <= edge often
+        if (temps[ch] <= thresholds[ch])
+            expected |= 1u << ch;
+    }
+    FUZZ_CHECK(simtemp_threshold_mask(temps, thresholds, n) == expected);
+}
+
+void op_generate(State &st, Input &in)
+{
+    auto mode = static_cast<enum simtemp_mode>(in.u8() % 4);   // 3 = out of range -> normal
+    unsigned int ch = in.u8() % SIMTEMP_MAX_CHANNELS;
+    u64 seq = u64(in.u32()) << (in.u8() % 33);
+    s32 t = simtemp_generate_temp(mode, seq, ch);
+
+    (void)st;
+    switch (mode) {
+    case SIMTEMP_MODE_NOISY:
+        FUZZ_CHECK(t >= 20000 && t <= 40000);
+        break;
+    case SIMTEMP_MODE_RAMP:
+        FUZZ_CHECK(t >= 25000 && t < 45000);
+        break;
+    default:
+        FUZZ_CHECK(t >= 25000 && t <= 35000);
+        break;
+    }
+}
+
+void op_adaptive(State &st, Input &in)
+{
+    struct simtemp_adaptive cfg;
+    s32 temps[SIMTEMP_MAX_CHANNELS];
+    s32 thresholds[SIMTEMP_MAX_CHANNELS];
+    s32 avg[SIMTEMP_MAX_CHANNELS];
+    s32 old_avg[SIMTEMP_MAX_CHANNELS];
+    unsigned int n = 1 + in.u8() % SIMTEMP_MAX_CHANNELS;
+
+    (void)st;
+    cfg.policy = in.u8() % 4;
+    cfg.min_ms = in.u32() % 12000;
+    cfg.max_ms = in.u32() % 12000;
+    cfg.step_ms = in.u32() % 12000;
+    cfg.band_mC = in.s32();
+    cfg.slope_mC = in.s32();
+    if (!simtemp_adaptive_valid(&cfg))
+        return;
+    FUZZ_CHECK(cfg.min_ms >= 1 && cfg.min_ms <= cfg.max_ms && cfg.max_ms <= 10000);
+
+    // The driver only ever feeds back a period within [1, 10000]
+    unsigned int period = 1 + in.u32() % 10000;
+    for (unsigned int ch = 0; ch < n; ch++) {
+        temps[ch] = in.s32();
+        thresholds[ch] = in.s32();
+        avg[ch] = old_avg[ch] = in.s32();
+    }
+
+    unsigned int next = simtemp_adaptive_next(&cfg, period, avg, temps, thresholds, n);
+    if (cfg.policy == SIMTEMP_ADAPTIVE_OFF)
+        FUZZ_CHECK(next == period);
+    else
+        FUZZ_CHECK(next >= cfg.min_ms && next <= cfg.max_ms);
+    // The average moves toward the sample and never overshoots it
+    for (unsigned int ch = 0; ch < n; ch++)
+        FUZZ_CHECK(std::min(old_avg[ch], temps[ch]) <= avg[ch] &&
+                   avg[ch] <= std::max(old_avg[ch], temps[ch]));
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    Input in(data, size);
+    State st;
+
+    simtemp_port_seed(size);
+    while (!in.empty()) {
+        switch (in.u8() % 8) {
+        case 0:
+        case 1: op_ring_push(st, in); break;
+        case 2: op_ring_pop(st, in); break;
+        case 3: op_history(st, in); break;
+        case 4: op_frames(st, in); break;
+        case 5: op_threshold(st, in); break;
+        case 6: op_generate(st, in); break;
+        case 7: op_adaptive(st, in); break;
+        }
+        FUZZ_CHECK(st.ring.count == int(st.ring_model.size()));
+        FUZZ_CHECK(st.hist.count == int(st.hist_model.size()));
+    }
+    return 0;
+}
+
+#ifdef SIMTEMP_FUZZ_STANDALONE
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// ./simtemp_core_fuzz [-runs=N] [-seed=S] [file...]
+int main(int argc, char *argv[])
+{
+    unsigned long runs = 100000;
+    unsigned long seed = 1;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "-runs=", 6) == 0) {
+            runs = strtoul(argv[i] + 6, nullptr, 0);
+        } else if (strncmp(argv[i], "-seed=", 6) == 0) {
+            seed = strtoul(argv[i] + 6, nullptr, 0);
+        } else {
+            std::ifstream f(argv[i], std::ios::binary);
+            if (!f) {
+                fprintf(stderr, "simtemp_core_fuzz: cannot open %s\n", argv[i]);
+                return 1;
+            }
+            std::vector<uint8_t> buf((std::istreambuf_iterator<char>(f)), {});
+            LLVMFuzzerTestOneInput(buf.data(), buf.size());
+            files++;
+        }
+    }
+    if (files > 0) {
+        printf("simtemp_core_fuzz: %d input(s) replayed, no failures\n", files);
+        return 0;
+    }
+
+    // No corpus: random scripts of random length (no coverage feedback)
+    std::mt19937_64 rng(seed);
+    std::vector<uint8_t> buf;
+    for (unsigned long r = 0; r < runs; r++) {
+        buf.resize(rng() % 4096);
+        for (auto &b : buf)
+            b = uint8_t(rng());
+        LLVMFuzzerTestOneInput(buf.data(), buf.size());
+    }
+    printf("simtemp_core_fuzz: %lu random inputs (seed %lu), no failures\n", runs, seed);
+    return 0;
+}
+
+#endif // SIMTEMP_FUZZ_STANDALONE
@@ -0,0 +1,27 @@
+//
+// simtemp_port_user.c - userspace side of kernel/simtemp_port.h.
+//
+// get_random_u32() is a per-thread xorshift32: cheap and reproducible,
+// which is what benchmarks and fuzz replays need (not cryptographic).
+//
+
+#include "simtemp_port.h"
+
+static __thread u32 simtemp_rng_state = 0x2545f491;
+
+void simtemp_port_seed(u32 seed)
+{
+    // xorshift has a fixed point at 0
+    simtemp_rng_state = seed ? seed : 0x2545f491;
+}
+
+u32 get_random_u32(void)
+{
+    u32 x = simtemp_rng_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    simtemp_rng_state = x;
+    return x;
+}
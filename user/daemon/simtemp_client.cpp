@@ -0,0 +1,213 @@
+//
+// simtemp_client.cpp - attach to the simtempd ring and read with per-client
+// cursors (see simtemp_shm.h for the layout and the overrun rules).
+//
+
+#include "simtemp_client.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "simtemp_shm.h"
+
+namespace simtemp {
+
+namespace {
+
+constexpr int64_t kLivenessCheckMs = 1000; // longest futex sleep before re-checking the daemon
+
+int64_t now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+} // namespace
+
+Client::Client(const char *shm_name)
+{
+    int fd = shm_open(shm_name ? shm_name : kShmName, O_RDWR, 0);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open (is simtempd running?)");
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(ShmLayout)) {
+        close(fd);
+        throw std::system_error(EPROTO, std::generic_category(), "simtemp shm too small");
+    }
+
+    void *mem = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), "mmap");
+
+    shm_ = static_cast<ShmLayout *>(mem);
+    size_ = st.st_size;
+
+    // Every client can write the mapping, so the capacity is read once,
+    // validated against the mapping size and never trusted again
+    const ShmHeader &hdr = shm_->header;
+    uint32_t capacity = *static_cast<const volatile uint32_t *>(&hdr.capacity);
+    if (hdr.magic != kShmMagic || hdr.version != kShmVersion ||
+        hdr.record_size != sizeof(struct simtemp_sample) ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 || shm_size(capacity) > size_) {
+        munmap(shm_, size_);
+        throw std::system_error(EPROTO, std::generic_category(), "simtemp shm layout mismatch");
+    }
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+
+    // Claim a free cursor slot
+    uint32_t pid = getpid();
+    for (auto &client : shm_->clients) {
+        uint32_t expected = 0;
+        if (client.pid.compare_exchange_strong(expected, pid)) {
+            slot_ = &client;
+            break;
+        }
+    }
+    if (!slot_) {
+        munmap(shm_, size_);
+        throw std::system_error(EUSERS, std::generic_category(), "all simtemp client slots in use");
+    }
+
+    // New clients start at the live edge
+    slot_->overruns.store(0, std::memory_order_relaxed);
+    slot_->cursor.store(hdr.write_seq.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+Client::~Client()
+{
+    slot_->pid.store(0, std::memory_order_release);
+    munmap(shm_, size_);
+}
+
+// Copy what is available without blocking
+unsigned int Client::drain(struct simtemp_sample *out, unsigned int max)
+{
+    const struct simtemp_sample *ring = shm_ring(shm_);
+    const uint64_t capacity = capacity_;
+    const uint64_t mask = mask_;
+    uint64_t cur = slot_->cursor.load(std::memory_order_relaxed);
+
+    for (;;) {
+        uint64_t head = shm_->header.write_seq.load(std::memory_order_acquire);
+        uint64_t claim = shm_->header.claim_seq.load(std::memory_order_relaxed);
+
+        // Fell behind: skip to the oldest slot the producer is not rewriting
+        if (claim - cur > capacity) {
+            slot_->overruns.fetch_add(claim - cur - capacity, std::memory_order_relaxed);
+            cur = claim - capacity;
+        }
+
+        unsigned int n = unsigned(std::min<uint64_t>(max, head - cur));
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = ring[(cur + i) & mask];
+
+        // Seqlock read side: if the producer claimed any of the copied slots
+        // meanwhile (even mid-write), the copy may be torn, so retry
+        std::atomic_thread_fence(std::memory_order_acquire);
+        claim = shm_->header.claim_seq.load(std::memory_order_relaxed);
+        if (claim - cur > capacity)
+            continue;
+
+        slot_->cursor.store(cur + n, std::memory_order_release);
+        return n;
+    }
+}
+
+int Client::read(struct simtemp_sample *out, unsigned int max, int timeout_ms)
+{
+    ShmHeader &hdr = shm_->header;
+    int64_t deadline = timeout_ms < 0 ? -1 : now_ms() + timeout_ms;
+
+    if (max == 0)
+        return -EINVAL;
+
+    bool timed_out = false;
+
+    for (;;) {
+        // Sample the futex word before checking, so a publish in between
+        // makes FUTEX_WAIT return immediately instead of sleeping
+        uint32_t word = hdr.futex_word.load(std::memory_order_seq_cst);
+
+        unsigned int n = drain(out, max);
+        if (n > 0)
+            return n;
+
+        // A clean exit clears daemon_pid; a killed daemon only shows up as
+        // a dead pid, so probe it after every quiet slice
+        uint32_t pid = hdr.daemon_pid.load(std::memory_order_acquire);
+        if (pid == 0 || (timed_out && kill(pid, 0) < 0 && errno == ESRCH))
+            return -ENODEV;
+
+        int64_t slice = kLivenessCheckMs;
+        if (deadline >= 0) {
+            int64_t left = deadline - now_ms();
+            if (left <= 0)
+                return 0;
+            slice = std::min(slice, left);
+        }
+        struct timespec ts;
+        ts.tv_sec = slice / 1000;
+        ts.tv_nsec = (slice % 1000) * 1000000;
+
+        timed_out = false;
+        hdr.waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (hdr.futex_word.load(std::memory_order_seq_cst) == word)
+            timed_out = futex_wait(&hdr.futex_word, word, &ts) < 0 && errno == ETIMEDOUT;
+        hdr.waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+uint64_t Client::overruns() const
+{
+    return slot_->overruns.load(std::memory_order_relaxed);
+}
+
+} // namespace simtemp
+
+// --- C ABI ---
+
+struct simtemp_client {
+    simtemp::Client impl;
+    explicit simtemp_client(const char *name) : impl(name) {}
+};
+
+extern "C" struct simtemp_client *simtemp_client_open(const char *shm_name)
+{
+    try {
+        return new simtemp_client(shm_name);
+    } catch (const std::system_error &e) {
+        errno = e.code().value();
+    } catch (const std::bad_alloc &) {
+        errno = ENOMEM;
+    }
+    return nullptr;
+}
+
+extern "C" int simtemp_client_read(struct simtemp_client *client, struct simtemp_sample *out,
+                                   unsigned int max, int timeout_ms)
+{
+    return client->impl.read(out, max, timeout_ms);
+}
+
+extern "C" uint64_t simtemp_client_overruns(const struct simtemp_client *client)
+{
+    return client->impl.overruns();
+}
+
+extern "C" void simtemp_client_close(struct simtemp_client *client)
+{
+    delete client;
+}
@@ -0,0 +1,72 @@
+#ifndef SIMTEMP_CLIENT_H
+#define SIMTEMP_CLIENT_H
+
+//
+// Client library for the simtempd shared-memory ring.
+//
+// C++: simtemp::Client (RAII). C ABI (used by simtemp_client.py via ctypes):
+// simtemp_client_open/read/overruns/close.
+//
+
+#include <stdint.h>
+
+#include "../../kernel/nxp_simtemp_ioctl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct simtemp_client;
+
+// Attach to the ring published by simtempd; NULL (and errno) on failure
+struct simtemp_client *simtemp_client_open(const char *shm_name);
+
+// Copy up to 'max' new samples. Waits up to timeout_ms (-1 = forever) if none
+// are queued. Returns the count, 0 on timeout, -ENODEV once the daemon exits
+// (or within about a second of it being killed).
+int simtemp_client_read(struct simtemp_client *client, struct simtemp_sample *out,
+                        unsigned int max, int timeout_ms);
+
+// Samples this client lost by falling more than 'capacity' behind
+uint64_t simtemp_client_overruns(const struct simtemp_client *client);
+
+void simtemp_client_close(struct simtemp_client *client);
+
+#ifdef __cplusplus
+} // extern "C"
+
+#include <cstddef>
+
+namespace simtemp {
+
+struct ShmLayout;
+struct ShmClient;
+
+class Client {
+public:
+    // Throws std::system_error if the daemon is not running
+    explicit Client(const char *shm_name = nullptr);
+    ~Client();
+
+    Client(const Client &) = delete;
+    Client &operator=(const Client &) = delete;
+
+    // See simtemp_client_read()
+    int read(struct simtemp_sample *out, unsigned int max, int timeout_ms = -1);
+
+    uint64_t overruns() const;
+
+private:
+    unsigned int drain(struct simtemp_sample *out, unsigned int max);
+
+    ShmLayout *shm_ = nullptr;
+    ShmClient *slot_ = nullptr;
+    size_t size_ = 0;
+    uint64_t capacity_ = 0;  // from the header at attach, checked against size_
+    uint64_t mask_ = 0;
+};
+
+} // namespace simtemp
+#endif // __cplusplus
+
+#endif // SIMTEMP_CLIENT_H
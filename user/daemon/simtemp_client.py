@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""
+Python client for the simtempd shared-memory ring.
+
+Thin ctypes wrapper over libsimtemp_client.so (build it with 'make' in
+user/daemon). Records come back as (timestamp_ns, temp_mC, flags) tuples,
+the same fields the CLI unpacks from /dev/simtemp.
+"""
+
+import ctypes
+import errno
+import os
+from pathlib import Path
+
+# Must match struct simtemp_sample in nxp_simtemp_ioctl.h (packed, 16 bytes)
+class SimtempSample(ctypes.Structure):
+    _pack_ = 1
+    _fields_ = [
+        ("timestamp_ns", ctypes.c_uint64),
+        ("temp_mC", ctypes.c_int32),
+        ("flags", ctypes.c_uint32),
+    ]
+
+LIB_PATH = Path(__file__).resolve().parent / "libsimtemp_client.so"
+BATCH_SAMPLES = 256
+
+def _load_lib():
+    lib = ctypes.CDLL(str(LIB_PATH), use_errno=True)
+    lib.simtemp_client_open.argtypes = [ctypes.c_char_p]
+    lib.simtemp_client_open.restype = ctypes.c_void_p
+    lib.simtemp_client_read.argtypes = [ctypes.c_void_p, ctypes.POINTER(SimtempSample),
+                                        ctypes.c_uint, ctypes.c_int]
+    lib.simtemp_client_read.restype = ctypes.c_int
+    lib.simtemp_client_overruns.argtypes = [ctypes.c_void_p]
+    lib.simtemp_client_overruns.restype = ctypes.c_uint64
+    lib.simtemp_client_close.argtypes = [ctypes.c_void_p]
+    lib.simtemp_client_close.restype = None
+    return lib
+
+class SimtempClient:
+    """One cursor on the daemon's ring. Use as a context manager."""
+
+    def __init__(self, shm_name=None):
+        self._lib = _load_lib()
+        name = shm_name.encode() if shm_name else None
+        self._handle = self._lib.simtemp_client_open(name)
+        if not self._handle:
+            err = ctypes.get_errno()
+            raise OSError(err, f"{os.strerror(err)} (is simtempd running?)")
+        self._buf = (SimtempSample * BATCH_SAMPLES)()
+
+    def read(self, timeout_ms=-1):
+        """Return a list of (timestamp_ns, temp_mC, flags); [] on timeout."""
+        n = self._lib.simtemp_client_read(self._handle, self._buf, BATCH_SAMPLES, timeout_ms)
+        if n == -errno.ENODEV:
+            raise EOFError("simtempd exited")
+        if n < 0:
+            raise OSError(-n, os.strerror(-n))
+        return [(s.timestamp_ns, s.temp_mC, s.flags) for s in self._buf[:n]]
+
+    @property
+    def overruns(self):
+        """Samples lost because this client fell too far behind."""
+        return self._lib.simtemp_client_overruns(self._handle)
+
+    def close(self):
+        if self._handle:
+            self._lib.simtemp_client_close(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
@@ -0,0 +1,104 @@
+#ifndef SIMTEMP_SHM_H
+#define SIMTEMP_SHM_H
+
+//
+// Shared-memory ring published by simtempd (the single /dev/simtemp reader).
+// Shared by the daemon and the client library; the offsets are fixed so
+// other languages can map it too (checked with static_assert below).
+//
+// Layout of /dev/shm/simtemp:
+//   0    ShmHeader                 (64 bytes)
+//   64   ShmClient[kMaxClients]    (one cache line per client)
+//   2112 simtemp_sample[capacity]  (capacity is a power of two)
+//
+// Single producer, broadcast ring: the daemon announces a batch in
+// claim_seq, writes slot (seq % capacity) and then publishes write_seq.
+// Every client owns a cursor; a client that falls more than 'capacity'
+// behind claim_seq loses the oldest samples (overrun).
+//
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <ctime>
+#include <string>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../../kernel/nxp_simtemp_ioctl.h"
+
+namespace simtemp {
+
+constexpr const char *kShmName = "/simtemp"; // shm_open() name
+constexpr uint32_t kShmMagic = 0x504d5453;   // "STMP"
+constexpr uint32_t kShmVersion = 2;
+constexpr uint32_t kMaxClients = 32;
+constexpr uint32_t kDefaultCapacity = 1 << 16; // samples (1 MiB ring)
+
+struct ShmHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;                 // ring slots, power of two
+    uint32_t record_size;              // sizeof(struct simtemp_sample)
+    std::atomic<uint32_t> daemon_pid;  // 0 once the daemon exits
+    std::atomic<uint32_t> futex_word;  // bumped on every published batch
+    std::atomic<uint64_t> write_seq;   // samples published so far
+    std::atomic<uint32_t> waiters;     // clients sleeping on futex_word
+    uint32_t reserved0;
+    std::atomic<uint64_t> claim_seq;   // end of the batch being written (>= write_seq)
+    uint32_t reserved[4];
+};
+
+struct alignas(64) ShmClient {
+    std::atomic<uint32_t> pid;         // 0 = free slot
+    uint32_t reserved;
+    std::atomic<uint64_t> cursor;      // next sequence this client reads
+    std::atomic<uint64_t> overruns;    // samples lost by falling behind
+};
+
+struct ShmLayout {
+    ShmHeader header;
+    ShmClient clients[kMaxClients];
+    // followed by struct simtemp_sample ring[capacity]
+};
+
+static_assert(sizeof(ShmHeader) == 64, "ShmHeader layout changed");
+static_assert(sizeof(ShmClient) == 64, "ShmClient layout changed");
+static_assert(offsetof(ShmHeader, write_seq) == 24, "ShmHeader layout changed");
+static_assert(sizeof(ShmLayout) == 64 + 64 * kMaxClients, "ShmLayout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "need lock-free 64-bit atomics");
+
+// Owner lock: simtempd holds flock(LOCK_EX) on this object for its whole
+// lifetime. It is never unlinked, so two daemons always lock the same inode.
+inline std::string shm_lock_name(const char *shm_name)
+{
+    return std::string(shm_name) + ".lock";
+}
+
+inline size_t shm_size(uint32_t capacity)
+{
+    return sizeof(ShmLayout) + size_t(capacity) * sizeof(struct simtemp_sample);
+}
+
+inline struct simtemp_sample *shm_ring(ShmLayout *shm)
+{
+    return reinterpret_cast<struct simtemp_sample *>(shm + 1);
+}
+
+// Futex on a word that lives in a MAP_SHARED mapping (so no FUTEX_PRIVATE_FLAG)
+inline int futex_wait(std::atomic<uint32_t> *word, uint32_t expected, const struct timespec *timeout)
+{
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+inline int futex_wake_all(std::atomic<uint32_t> *word)
+{
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace simtemp
+
+#endif // SIMTEMP_SHM_H
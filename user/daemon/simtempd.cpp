@@ -0,0 +1,265 @@
+//
+// simtempd - single reader of /dev/simtemp that fans samples out to any
+// number of local clients through a POSIX shared-memory ring.
+//
+// Usage: simtempd [-d /dev/simtemp] [-n /simtemp] [-c capacity] [-v]
+//
+// The daemon drains the driver with SIMTEMP_IOC_READ_BATCH (one syscall per
+// batch instead of one per sample), appends the batch to the ring, bumps the
+// futex word and wakes sleeping clients only if someone is waiting.
+//
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "simtemp_shm.h"
+
+namespace {
+
+constexpr uint32_t kBatchSamples = 256;  // per ioctl (the driver caps it at its ring size)
+constexpr int kReapEveryBatches = 64;    // how often dead client slots are released
+constexpr unsigned kFramePollSec = 1;    // recheck interval while the device is in frame mode
+
+volatile sig_atomic_t g_stop = 0;
+
+void on_signal(int)
+{
+    g_stop = 1;
+}
+
+void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-d device] [-n shm_name] [-c capacity] [-v]\n", prog);
+    fprintf(stderr, "  -d  device node (default /dev/simtemp)\n");
+    fprintf(stderr, "  -n  shared-memory name (default %s)\n", simtemp::kShmName);
+    fprintf(stderr, "  -c  ring capacity in samples, power of two (default %u)\n",
+            simtemp::kDefaultCapacity);
+    fprintf(stderr, "  -v  log client lag after every reap pass\n");
+}
+
+// Take the owner lock for 'name'. Returns the fd to keep open for the
+// daemon's lifetime, or -1 if another daemon holds it.
+int lock_owner(const char *name)
+{
+    std::string lock_name = simtemp::shm_lock_name(name);
+    int fd = shm_open(lock_name.c_str(), O_CREAT | O_RDWR, 0666);
+    if (fd < 0) {
+        perror("shm_open (lock)");
+        return -1;
+    }
+    fchmod(fd, 0666);
+
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+        if (errno == EWOULDBLOCK)
+            fprintf(stderr, "simtempd: /dev/shm%s is in use by another simtempd\n", name);
+        else
+            perror("flock");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Create the shared-memory ring and initialise the header. The caller holds
+// the owner lock, so any segment already there was left by a dead daemon.
+simtemp::ShmLayout *create_shm(const char *name, uint32_t capacity)
+{
+    size_t size = simtemp::shm_size(capacity);
+
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0) {
+        perror("shm_open");
+        return nullptr;
+    }
+    // Clients write their own cursor, so non-root readers need rw (like /dev/simtemp)
+    fchmod(fd, 0666);
+    if (ftruncate(fd, size) < 0) {
+        perror("ftruncate");
+        close(fd);
+        shm_unlink(name);
+        return nullptr;
+    }
+
+    void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        perror("mmap");
+        shm_unlink(name);
+        return nullptr;
+    }
+
+    // ftruncate() zero-fills, so every client slot starts free
+    auto *shm = static_cast<simtemp::ShmLayout *>(mem);
+    shm->header.magic = simtemp::kShmMagic;
+    shm->header.version = simtemp::kShmVersion;
+    shm->header.capacity = capacity;
+    shm->header.record_size = sizeof(struct simtemp_sample);
+    shm->header.daemon_pid.store(getpid(), std::memory_order_release);
+    return shm;
+}
+
+// Release slots of clients that died without closing
+void reap_clients(simtemp::ShmLayout *shm, bool verbose)
+{
+    uint64_t head = shm->header.write_seq.load(std::memory_order_acquire);
+
+    for (auto &client : shm->clients) {
+        uint32_t pid = client.pid.load(std::memory_order_acquire);
+        if (pid == 0)
+            continue;
+
+        if (kill(pid, 0) < 0 && errno == ESRCH) {
+            client.pid.compare_exchange_strong(pid, 0);
+            continue;
+        }
+
+        if (verbose)
+            fprintf(stderr, "simtempd: client pid=%u lag=%llu overruns=%llu\n", pid,
+                    (unsigned long long)(head - client.cursor.load(std::memory_order_relaxed)),
+                    (unsigned long long)client.overruns.load(std::memory_order_relaxed));
+    }
+}
+
+// Append a batch to the ring and wake clients
+void publish(simtemp::ShmLayout *shm, const struct simtemp_sample *samples, uint32_t count)
+{
+    struct simtemp_sample *ring = simtemp::shm_ring(shm);
+    uint32_t mask = shm->header.capacity - 1;
+    uint64_t seq = shm->header.write_seq.load(std::memory_order_relaxed);
+
+    // Seqlock write side: announce the slots about to be overwritten before
+    // touching them, so a lagging client copying them can tell
+    shm->header.claim_seq.store(seq + count, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (uint32_t i = 0; i < count; i++)
+        ring[(seq + i) & mask] = samples[i];
+
+    // Release: slot contents are visible before the new write_seq
+    shm->header.write_seq.store(seq + count, std::memory_order_release);
+
+    // Dekker pair with the client: bump the word, then check for sleepers
+    shm->header.futex_word.fetch_add(1, std::memory_order_seq_cst);
+    if (shm->header.waiters.load(std::memory_order_seq_cst) != 0)
+        simtemp::futex_wake_all(&shm->header.futex_word);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const char *device = "/dev/simtemp";
+    const char *shm_name = simtemp::kShmName;
+    uint32_t capacity = simtemp::kDefaultCapacity;
+    bool verbose = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:n:c:vh")) != -1) {
+        switch (opt) {
+        case 'd': device = optarg; break;
+        case 'n': shm_name = optarg; break;
+        case 'c': capacity = strtoul(optarg, nullptr, 0); break;
+        case 'v': verbose = true; break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    // A batch larger than the ring would overwrite itself
+    if (capacity < kBatchSamples || (capacity & (capacity - 1)) != 0) {
+        fprintf(stderr, "simtempd: capacity must be a power of two >= %u\n", kBatchSamples);
+        return 1;
+    }
+
+    // No SA_RESTART: SIGINT/SIGTERM must interrupt the blocking ioctl
+    struct sigaction sa = {};
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    int dev_fd = open(device, O_RDONLY);
+    if (dev_fd < 0) {
+        fprintf(stderr, "simtempd: cannot open %s: %s (is the module loaded?)\n",
+                device, strerror(errno));
+        return 1;
+    }
+
+    int lock_fd = lock_owner(shm_name);
+    if (lock_fd < 0) {
+        close(dev_fd);
+        return 1;
+    }
+
+    simtemp::ShmLayout *shm = create_shm(shm_name, capacity);
+    if (!shm) {
+        close(lock_fd);
+        close(dev_fd);
+        return 1;
+    }
+
+    fprintf(stderr, "simtempd: %s -> /dev/shm%s (%u samples)\n", device, shm_name, capacity);
+
+    struct simtemp_sample samples[kBatchSamples];
+    int batches = 0;
+    int ret = 0;
+    bool paused = false;
+
+    while (!g_stop) {
+        struct simtemp_batch batch = {};
+        batch.samples = reinterpret_cast<uintptr_t>(samples);
+        batch.max_samples = kBatchSamples;
+
+        // Blocks until the driver has at least one sample
+        if (ioctl(dev_fd, SIMTEMP_IOC_READ_BATCH, &batch) < 0) {
+            if (errno == EINTR)
+                continue;
+            // Multi-channel mode has no records to fan out: keep the ring
+            // and the clients, and resume once channels is back to 1
+            if (errno == EINVAL) {
+                if (!paused)
+                    fprintf(stderr, "simtempd: device is in multi-channel mode, waiting\n");
+                paused = true;
+                sleep(kFramePollSec);
+                continue;
+            }
+            fprintf(stderr, "simtempd: SIMTEMP_IOC_READ_BATCH failed: %s\n", strerror(errno));
+            ret = 1;
+            break;
+        }
+
+        if (paused) {
+            fprintf(stderr, "simtempd: device is back in single-channel mode\n");
+            paused = false;
+        }
+
+        if (batch.count > 0)
+            publish(shm, samples, batch.count);
+
+        if (++batches % kReapEveryBatches == 0)
+            reap_clients(shm, verbose);
+    }
+
+    // Tell clients we are gone, then wake them so they notice
+    shm->header.daemon_pid.store(0, std::memory_order_release);
+    shm->header.futex_word.fetch_add(1, std::memory_order_seq_cst);
+    simtemp::futex_wake_all(&shm->header.futex_word);
+
+    munmap(shm, simtemp::shm_size(capacity));
+    shm_unlink(shm_name);
+    close(lock_fd); // Releases the owner lock (the lock object itself stays)
+    close(dev_fd);
+    fprintf(stderr, "simtempd: stopped\n");
+    return ret;
+}
@@ -9,6 +9,7 @@ import struct
 import time
 import random
 import sys
+import argparse
 from pathlib import Path
 
 
@@ -64,14 +65,46 @@ class DeviceWorker(threading.Thread):
     This thread runs in the background. Its only job is to
     block on poll() and read from the kernel device.
     """
-    def __init__(self, data_queue):
+    def __init__(self, data_queue, via_daemon=False):
         super().__init__(daemon=True) # daemon=True so it dies if the GUI dies
         self.data_queue = data_queue
+        self.via_daemon = via_daemon
         self.running = True
         self.fd = None
         self.poller = None
 
+    def run_via_daemon(self):
+        """Same job, but fed by simtempd's shared-memory ring (no POLLPRI there)."""
+        try:
+            sys.path.append(str(Path(__file__).resolve().parent.parent / "daemon"))
+            from simtemp_client import SimtempClient
+            client = SimtempClient()
+        except Exception as e:
+            self.data_queue.put({"error": f"simtempd: {e}"})
+            return
+
+        with client:
+            while self.running:
+                try:
+                    # 1s timeout so the loop can check self.running
+                    for timestamp, temp, flags in client.read(1000):
+                        self.data_queue.put({
+                            "temp_c": temp / 1000.0,
+                            "alert_triggered": bool(flags & SIMTEMP_FLAG_THRESHOLD_CROSSED),
+                            "timestamp_ns": timestamp,
+                            "error": None
+                        })
+                except EOFError:
+                    self.data_queue.put({"error": "simtempd exited"})
+                    return
+                except Exception as e:
+                    self.data_queue.put({"error": str(e)})
+                    time.sleep(1) # Avoid error spamming
+
     def run(self):
+        if self.via_daemon:
+            return self.run_via_daemon()
+
         try:
             self.fd = os.open(DEVICE_PATH, os.O_RDONLY | os.O_NONBLOCK)
             self.poller = select.poll()
@@ -127,7 +160,7 @@ class MainApplication(ttk.Frame):
     """
     Main GUI class, now integrated with the Worker Thread
     """
-    def __init__(self, master):
+    def __init__(self, master, via_daemon=False):
         super().__init__(master, padding="10")
         self.master = master
         self.master.title("NXP simtemp Dashboard (con Gráfico)")
@@ -146,7 +179,7 @@ class MainApplication(ttk.Frame):
         self.create_widgets()
 
         # start Worker Thread (from final code)
-        self.worker = DeviceWorker(self.data_queue)
+        self.worker = DeviceWorker(self.data_queue, via_daemon)
         self.worker.start()
 
         #Start Queue Polling Loop (from final code)
@@ -414,6 +447,15 @@ class MainApplication(ttk.Frame):
 
 # --- Main Execution Block ---
 if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser(description="GUI dashboard for NXP simtemp driver")
+    parser.add_argument(
+        '--via-daemon',
+        action='store_true',
+        help="Read samples from the simtempd shared-memory ring instead of /dev/simtemp "
+             "(single-channel mode only: simtempd pauses while channels > 1)"
+    )
+    args = parser.parse_args()
     
     if os.geteuid() != 0:
         print("Warning: Script is not running as root (sudo).")
@@ -427,7 +469,7 @@ if __name__ == "__main__":
     except tk.TclError:
         print("Theme 'clam' not available, using default.")
 
-    app = MainApplication(master=root)
+    app = MainApplication(master=root, via_daemon=args.via_daemon)
     app.pack(fill="both", expand=True)
     
     # Start the GUI loop
@@ -0,0 +1,774 @@
+//
+// simtemp_rec - record the simtemp stream into indexed, segment-rotated
+// binary files and query them back through mmap.
+//
+//   simtemp_rec record DIR [-d device | -D] [-s segment_MiB]
+//   simtemp_rec info   DIR
+//   simtemp_rec query  DIR [-f from_ns] [-t to_ns] [-a above_mC] [-p] [-S]
+//   simtemp_rec export DIR [-f from_ns] [-t to_ns] [-a above_mC] [-o file.csv]
+//   simtemp_rec bench  DIR [-g GiB] [-s segment_MiB] [-q queries] [-k]
+//
+// Timestamps are the driver's ktime_get_ns() values (see 'info' for the
+// range of a capture). See simtemp_rec_format.h for the file layout.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "simtemp_rec_format.h"
+#include "../daemon/simtemp_client.h"
+
+using namespace simtemp::rec;
+
+namespace {
+
+constexpr uint32_t kBatchSamples = 4096;   // records per drain / per write()
+constexpr uint64_t kDefaultSegmentMiB = 256;
+
+volatile sig_atomic_t g_stop = 0;
+
+void on_signal(int)
+{
+    g_stop = 1;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string segment_path(const std::string &dir, uint64_t index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/seg-%06" PRIu64 ".stmp", index);
+    return dir + name;
+}
+
+// Segment indexes present in 'dir', sorted
+std::vector<uint64_t> list_segments(const std::string &dir)
+{
+    std::vector<uint64_t> out;
+    DIR *d = opendir(dir.c_str());
+    if (!d)
+        return out;
+
+    while (struct dirent *ent = readdir(d)) {
+        uint64_t index;
+        char tail;
+        if (sscanf(ent->d_name, "seg-%" SCNu64 ".stm%c", &index, &tail) == 2 && tail == 'p')
+            out.push_back(index);
+    }
+    closedir(d);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+bool write_all(int fd, const void *data, size_t len)
+{
+    const char *p = static_cast<const char *>(data);
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+void block_add(BlockInfo &blk, const struct simtemp_sample &s)
+{
+    if (blk.count == 0) {
+        blk.first_ts_ns = s.timestamp_ns;
+        blk.min_mC = s.temp_mC;
+        blk.max_mC = s.temp_mC;
+    }
+    blk.last_ts_ns = s.timestamp_ns;
+    blk.min_mC = std::min<int32_t>(blk.min_mC, s.temp_mC);
+    blk.max_mC = std::max<int32_t>(blk.max_mC, s.temp_mC);
+    blk.count++;
+    if (s.flags & SIMTEMP_FLAG_THRESHOLD_CROSSED)
+        blk.alerts++;
+}
+
+// --- Writer: append-only, rotates every 'segment_samples' records ---
+
+class SegmentWriter {
+public:
+    SegmentWriter(std::string dir, uint64_t segment_bytes, uint32_t block_samples = kDefaultBlockSamples)
+        : dir_(std::move(dir)), block_samples_(block_samples)
+    {
+        // Whole blocks per segment, at least one
+        uint64_t blocks = std::max<uint64_t>(1, segment_bytes / (uint64_t(block_samples) * sizeof(struct simtemp_sample)));
+        segment_samples_ = blocks * block_samples;
+
+        std::vector<uint64_t> existing = list_segments(dir_);
+        next_index_ = existing.empty() ? 0 : existing.back() + 1;
+    }
+
+    ~SegmentWriter()
+    {
+        close();
+    }
+
+    bool append(const struct simtemp_sample *samples, size_t n)
+    {
+        while (n > 0) {
+            if (fd_ < 0 && !open_next())
+                return false;
+
+            size_t room = segment_samples_ - nsamples_;
+            size_t chunk = std::min(n, room);
+
+            if (!write_all(fd_, samples, chunk * sizeof(*samples))) {
+                perror("simtemp_rec: write");
+                return false;
+            }
+            for (size_t i = 0; i < chunk; i++) {
+                block_add(cur_, samples[i]);
+                if (cur_.count == block_samples_) {
+                    blocks_.push_back(cur_);
+                    cur_ = BlockInfo();
+                }
+            }
+            nsamples_ += chunk;
+            samples += chunk;
+            n -= chunk;
+
+            if (nsamples_ == segment_samples_ && !finish())
+                return false;
+        }
+        return true;
+    }
+
+    // Write the footer of the open segment (if any)
+    bool close()
+    {
+        return fd_ < 0 || finish();
+    }
+
+    uint64_t segments_written() const
+    {
+        return segments_written_;
+    }
+
+private:
+    bool open_next()
+    {
+        std::string path = segment_path(dir_, next_index_);
+        fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd_ < 0) {
+            fprintf(stderr, "simtemp_rec: cannot create %s: %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+
+        SegHeader hdr = {};
+        hdr.magic = kSegMagic;
+        hdr.version = kFormatVersion;
+        hdr.record_size = sizeof(struct simtemp_sample);
+        hdr.block_samples = block_samples_;
+        hdr.segment_index = next_index_++;
+        if (!write_all(fd_, &hdr, sizeof(hdr))) {
+            perror("simtemp_rec: write");
+            return false;
+        }
+
+        nsamples_ = 0;
+        blocks_.clear();
+        cur_ = BlockInfo();
+        return true;
+    }
+
+    bool finish()
+    {
+        if (cur_.count > 0)
+            blocks_.push_back(cur_);
+
+        SegTrailer tr = {};
+        tr.magic = kTrailerMagic;
+        tr.nsamples = nsamples_;
+        tr.nblocks = blocks_.size();
+        tr.index_offset = sizeof(SegHeader) + nsamples_ * sizeof(struct simtemp_sample);
+        tr.min_mC = INT32_MAX;
+        tr.max_mC = INT32_MIN;
+        if (!blocks_.empty()) {
+            tr.first_ts_ns = blocks_.front().first_ts_ns;
+            tr.last_ts_ns = blocks_.back().last_ts_ns;
+        }
+        for (const BlockInfo &b : blocks_) {
+            tr.min_mC = std::min(tr.min_mC, b.min_mC);
+            tr.max_mC = std::max(tr.max_mC, b.max_mC);
+        }
+
+        bool ok = write_all(fd_, blocks_.data(), blocks_.size() * sizeof(BlockInfo)) &&
+                  write_all(fd_, &tr, sizeof(tr)) &&
+                  fdatasync(fd_) == 0;
+        if (!ok)
+            perror("simtemp_rec: writing footer");
+
+        ::close(fd_);
+        fd_ = -1;
+        segments_written_++;
+        return ok;
+    }
+
+    std::string dir_;
+    uint32_t block_samples_;
+    uint64_t segment_samples_;
+    uint64_t next_index_;
+    uint64_t segments_written_ = 0;
+
+    int fd_ = -1;
+    uint64_t nsamples_ = 0;
+    std::vector<BlockInfo> blocks_;
+    BlockInfo cur_ = {};
+};
+
+// --- Reader: mmap a segment, use its footer (or rebuild it) ---
+
+class Segment {
+public:
+    bool open(const std::string &path, bool use_index = true)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(SegHeader)) {
+            ::close(fd);
+            return false;
+        }
+        size_ = st.st_size;
+        map_ = static_cast<const uint8_t *>(mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0));
+        ::close(fd);
+        if (map_ == MAP_FAILED) {
+            map_ = nullptr;
+            return false;
+        }
+
+        const auto *hdr = reinterpret_cast<const SegHeader *>(map_);
+        if (hdr->magic != kSegMagic || hdr->record_size != sizeof(struct simtemp_sample) ||
+            hdr->block_samples == 0) {
+            fprintf(stderr, "simtemp_rec: %s is not a segment\n", path.c_str());
+            return false;
+        }
+        block_samples_ = hdr->block_samples;
+        samples_ = reinterpret_cast<const struct simtemp_sample *>(map_ + sizeof(SegHeader));
+
+        if (use_index && load_footer())
+            return true;
+        rebuild_index();
+        return true;
+    }
+
+    ~Segment()
+    {
+        if (map_)
+            munmap(const_cast<uint8_t *>(map_), size_);
+    }
+
+    const struct simtemp_sample *samples() const { return samples_; }
+    const BlockInfo *blocks() const { return blocks_; }
+    uint64_t nblocks() const { return nblocks_; }
+    uint64_t nsamples() const { return nsamples_; }
+    uint32_t block_samples() const { return block_samples_; }
+    bool indexed() const { return indexed_; }
+
+private:
+    bool load_footer()
+    {
+        if (size_ < sizeof(SegHeader) + sizeof(SegTrailer))
+            return false;
+
+        const auto *tr = reinterpret_cast<const SegTrailer *>(map_ + size_ - sizeof(SegTrailer));
+        if (tr->magic != kTrailerMagic ||
+            tr->index_offset != sizeof(SegHeader) + tr->nsamples * sizeof(struct simtemp_sample) ||
+            tr->index_offset + tr->nblocks * sizeof(BlockInfo) + sizeof(SegTrailer) != size_)
+            return false;
+
+        nsamples_ = tr->nsamples;
+        nblocks_ = tr->nblocks;
+        blocks_ = reinterpret_cast<const BlockInfo *>(map_ + tr->index_offset);
+        indexed_ = true;
+        return true;
+    }
+
+    // Unfinished segment: rebuild the footer in memory from the records.
+    // Timestamps only move forward, so the first step back marks the end of
+    // valid data (e.g. a half-written footer after a crash).
+    void rebuild_index()
+    {
+        uint64_t max = (size_ - sizeof(SegHeader)) / sizeof(struct simtemp_sample);
+        nsamples_ = 0;
+        while (nsamples_ < max &&
+               (nsamples_ == 0 || samples_[nsamples_].timestamp_ns >= samples_[nsamples_ - 1].timestamp_ns))
+            nsamples_++;
+
+        rebuilt_.clear();
+        for (uint64_t i = 0; i < nsamples_; i += block_samples_) {
+            BlockInfo blk = {};
+            uint64_t end = std::min<uint64_t>(nsamples_, i + block_samples_);
+            for (uint64_t j = i; j < end; j++)
+                block_add(blk, samples_[j]);
+            rebuilt_.push_back(blk);
+        }
+        blocks_ = rebuilt_.data();
+        nblocks_ = rebuilt_.size();
+        indexed_ = false;
+    }
+
+    const uint8_t *map_ = nullptr;
+    size_t size_ = 0;
+    const struct simtemp_sample *samples_ = nullptr;
+    const BlockInfo *blocks_ = nullptr;
+    std::vector<BlockInfo> rebuilt_;
+    uint64_t nblocks_ = 0;
+    uint64_t nsamples_ = 0;
+    uint32_t block_samples_ = 0;
+    bool indexed_ = false;
+};
+
+// --- Queries ---
+
+struct Query {
+    uint64_t from_ns = 0;
+    uint64_t to_ns = UINT64_MAX;
+    bool has_above = false;
+    int32_t above_mC = 0;     // match temp_mC > above_mC
+    bool use_index = true;    // false = full scan (baseline for the benchmark)
+};
+
+struct QueryStats {
+    uint64_t matched = 0;
+    uint64_t blocks_scanned = 0;
+    uint64_t blocks_skipped = 0;
+    uint64_t segments = 0;
+    int32_t min_mC = INT32_MAX;
+    int32_t max_mC = INT32_MIN;
+    int64_t sum_mC = 0;
+};
+
+// Calls fn(sample) for every match, in file order
+template <typename Fn>
+QueryStats run_query(const std::string &dir, const Query &q, Fn &&fn)
+{
+    QueryStats st;
+
+    for (uint64_t index : list_segments(dir)) {
+        Segment seg;
+        if (!seg.open(segment_path(dir, index)))
+            continue;
+        st.segments++;
+
+        const BlockInfo *blocks = seg.blocks();
+        const BlockInfo *end = blocks + seg.nblocks();
+        const BlockInfo *blk = blocks;
+
+        // Sparse index: first block that can contain 'from' (timestamps are
+        // monotonic inside a segment)
+        if (q.use_index)
+            blk = std::partition_point(blocks, end,
+                                       [&](const BlockInfo &b) { return b.last_ts_ns < q.from_ns; });
+        st.blocks_skipped += blk - blocks;
+
+        for (; blk < end; blk++) {
+            if (q.use_index) {
+                if (blk->first_ts_ns > q.to_ns) {
+                    st.blocks_skipped += end - blk;
+                    break;
+                }
+                // Min/max footer: nothing in this block can be above the threshold
+                if (q.has_above && blk->max_mC <= q.above_mC) {
+                    st.blocks_skipped++;
+                    continue;
+                }
+            }
+            st.blocks_scanned++;
+
+            const struct simtemp_sample *s = seg.samples() + (blk - blocks) * uint64_t(seg.block_samples());
+            for (uint32_t i = 0; i < blk->count; i++) {
+                if (s[i].timestamp_ns < q.from_ns || s[i].timestamp_ns > q.to_ns)
+                    continue;
+                if (q.has_above && s[i].temp_mC <= q.above_mC)
+                    continue;
+                st.matched++;
+                st.min_mC = std::min<int32_t>(st.min_mC, s[i].temp_mC);
+                st.max_mC = std::max<int32_t>(st.max_mC, s[i].temp_mC);
+                st.sum_mC += s[i].temp_mC;
+                fn(s[i]);
+            }
+        }
+    }
+    return st;
+}
+
+void print_stats(const QueryStats &st, double elapsed)
+{
+    printf("matched:   %" PRIu64 " samples in %" PRIu64 " segments\n", st.matched, st.segments);
+    if (st.matched)
+        printf("temp (C):  min %.3f  max %.3f  mean %.3f\n", st.min_mC / 1000.0, st.max_mC / 1000.0,
+               double(st.sum_mC) / st.matched / 1000.0);
+    printf("blocks:    %" PRIu64 " scanned, %" PRIu64 " skipped\n", st.blocks_scanned, st.blocks_skipped);
+    printf("elapsed:   %.3f ms\n", elapsed * 1e3);
+}
+
+// --- Commands ---
+
+void usage()
+{
+    fprintf(stderr,
+            "Usage:\n"
+            "  simtemp_rec record DIR [-d device | -D] [-s segment_MiB]\n"
+            "  simtemp_rec info   DIR\n"
+            "  simtemp_rec query  DIR [-f from_ns] [-t to_ns] [-a above_mC] [-p] [-S]\n"
+            "  simtemp_rec export DIR [-f from_ns] [-t to_ns] [-a above_mC] [-o file.csv]\n"
+            "  simtemp_rec bench  DIR [-g GiB] [-s segment_MiB] [-q queries] [-k]\n"
+            "\n"
+            "  -D  record through simtempd instead of opening the device\n"
+            "  -p  print matching samples as CSV\n"
+            "  -S  ignore the index (full scan, for comparison)\n"
+            "  -k  keep the benchmark segments\n");
+}
+
+int cmd_record(const std::string &dir, int argc, char *argv[])
+{
+    const char *device = "/dev/simtemp";
+    bool via_daemon = false;
+    uint64_t segment_mib = kDefaultSegmentMiB;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:Ds:")) != -1) {
+        switch (opt) {
+        case 'd': device = optarg; break;
+        case 'D': via_daemon = true; break;
+        case 's': segment_mib = strtoull(optarg, nullptr, 0); break;
+        default: usage(); return 1;
+        }
+    }
+
+    if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) {
+        fprintf(stderr, "simtemp_rec: cannot create %s: %s\n", dir.c_str(), strerror(errno));
+        return 1;
+    }
+
+    // No SA_RESTART: Ctrl+C must interrupt the blocking read so the footer gets written
+    struct sigaction sa = {};
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    std::vector<struct simtemp_sample> samples(kBatchSamples);
+    SegmentWriter writer(dir, segment_mib << 20);
+    uint64_t total = 0;
+    int ret = 0;
+
+    if (via_daemon) {
+        try {
+            simtemp::Client client;
+            fprintf(stderr, "simtemp_rec: recording simtempd -> %s\n", dir.c_str());
+            while (!g_stop) {
+                int n = client.read(samples.data(), kBatchSamples, 500);
+                if (n < 0) {
+                    fprintf(stderr, "simtemp_rec: simtempd: %s\n", strerror(-n));
+                    ret = 1;
+                    break;
+                }
+                if (n > 0 && !writer.append(samples.data(), n)) {
+                    ret = 1;
+                    break;
+                }
+                total += n;
+            }
+        } catch (const std::system_error &e) {
+            fprintf(stderr, "simtemp_rec: %s\n", e.what());
+            return 1;
+        }
+    } else {
+        int fd = open(device, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "simtemp_rec: cannot open %s: %s\n", device, strerror(errno));
+            return 1;
+        }
+        fprintf(stderr, "simtemp_rec: recording %s -> %s\n", device, dir.c_str());
+        while (!g_stop) {
+            struct simtemp_batch batch = {};
+            batch.samples = reinterpret_cast<uintptr_t>(samples.data());
+            batch.max_samples = kBatchSamples;
+
+            if (ioctl(fd, SIMTEMP_IOC_READ_BATCH, &batch) < 0) {
+                if (errno == EINTR)
+                    continue;
+                perror("simtemp_rec: SIMTEMP_IOC_READ_BATCH");
+                ret = 1;
+                break;
+            }
+            if (!writer.append(samples.data(), batch.count)) {
+                ret = 1;
+                break;
+            }
+            total += batch.count;
+        }
+        close(fd);
+    }
+
+    if (!writer.close())
+        ret = 1;
+    fprintf(stderr, "simtemp_rec: %" PRIu64 " samples, %" PRIu64 " segments closed\n",
+            total, writer.segments_written());
+    return ret;
+}
+
+int cmd_info(const std::string &dir)
+{
+    std::vector<uint64_t> segs = list_segments(dir);
+    if (segs.empty()) {
+        fprintf(stderr, "simtemp_rec: no segments in %s\n", dir.c_str());
+        return 1;
+    }
+
+    bool unfinished = false;
+
+    printf("%-18s %12s %8s %22s %22s %9s %9s\n", "segment", "samples", "blocks",
+           "first_ns", "last_ns", "min_C", "max_C");
+    for (uint64_t index : segs) {
+        Segment seg;
+        if (!seg.open(segment_path(dir, index)))
+            continue;
+
+        int32_t lo = INT32_MAX, hi = INT32_MIN;
+        for (uint64_t b = 0; b < seg.nblocks(); b++) {
+            lo = std::min(lo, seg.blocks()[b].min_mC);
+            hi = std::max(hi, seg.blocks()[b].max_mC);
+        }
+        uint64_t first = seg.nblocks() ? seg.blocks()[0].first_ts_ns : 0;
+        uint64_t last = seg.nblocks() ? seg.blocks()[seg.nblocks() - 1].last_ts_ns : 0;
+        printf("seg-%06" PRIu64 "%s %12" PRIu64 " %8" PRIu64 " %22" PRIu64 " %22" PRIu64 " %9.3f %9.3f\n",
+               index, seg.indexed() ? "     " : " (*) ", seg.nsamples(), seg.nblocks(),
+               first, last, lo / 1000.0, hi / 1000.0);
+        unfinished |= !seg.indexed();
+    }
+    if (unfinished)
+        printf("(*) no footer (unfinished segment), index rebuilt by scanning\n");
+    return 0;
+}
+
+// Shared option parsing for query/export
+bool parse_query(int argc, char *argv[], Query &q, bool &print, const char **out)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "f:t:a:o:pS")) != -1) {
+        switch (opt) {
+        case 'f': q.from_ns = strtoull(optarg, nullptr, 0); break;
+        case 't': q.to_ns = strtoull(optarg, nullptr, 0); break;
+        case 'a': q.has_above = true; q.above_mC = strtol(optarg, nullptr, 0); break;
+        case 'o': *out = optarg; break;
+        case 'p': print = true; break;
+        case 'S': q.use_index = false; break;
+        default: usage(); return false;
+        }
+    }
+    return true;
+}
+
+int cmd_query(const std::string &dir, int argc, char *argv[], bool export_csv)
+{
+    Query q;
+    bool print = export_csv;
+    const char *out_path = nullptr;
+
+    if (!parse_query(argc, argv, q, print, &out_path))
+        return 1;
+
+    FILE *out = stdout;
+    if (out_path && !(out = fopen(out_path, "w"))) {
+        fprintf(stderr, "simtemp_rec: cannot create %s: %s\n", out_path, strerror(errno));
+        return 1;
+    }
+    if (print)
+        fprintf(out, "timestamp_ns,temp_mC,flags\n");
+
+    auto start = std::chrono::steady_clock::now();
+    QueryStats st = run_query(dir, q, [&](const struct simtemp_sample &s) {
+        if (print)
+            fprintf(out, "%" PRIu64 ",%d,%u\n", uint64_t(s.timestamp_ns), int(s.temp_mC), unsigned(s.flags));
+    });
+    double elapsed = seconds_since(start);
+
+    if (out != stdout)
+        fclose(out);
+    // Keep CSV on stdout clean
+    if (!print || out != stdout)
+        print_stats(st, elapsed);
+    return 0;
+}
+
+// Synthetic 1 kHz capture: slow sine plus noise, so some blocks exceed 40 C
+void bench_fill(std::vector<struct simtemp_sample> &batch, uint64_t first, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int32_t> noise(-2000, 2000);
+    for (size_t i = 0; i < batch.size(); i++) {
+        uint64_t n = first + i;
+        batch[i].timestamp_ns = n * 1000000ULL;
+        batch[i].temp_mC = 30000 + int32_t(12000 * std::sin(double(n) / 200000.0)) + noise(rng);
+        batch[i].flags = SIMTEMP_FLAG_NEW_SAMPLE;
+    }
+}
+
+double percentile(std::vector<double> v, double p)
+{
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, size_t(p * v.size()))];
+}
+
+int cmd_bench(const std::string &dir, int argc, char *argv[])
+{
+    double gib = 2.0;
+    uint64_t segment_mib = kDefaultSegmentMiB;
+    int queries = 200;
+    bool keep = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "g:s:q:k")) != -1) {
+        switch (opt) {
+        case 'g': gib = strtod(optarg, nullptr); break;
+        case 's': segment_mib = strtoull(optarg, nullptr, 0); break;
+        case 'q': queries = atoi(optarg); break;
+        case 'k': keep = true; break;
+        default: usage(); return 1;
+        }
+    }
+
+    // Query windows are 1k .. 60k samples; the data set must hold the widest
+    constexpr uint64_t kMinWindow = 1000, kMaxWindow = 60000;
+    uint64_t total = gib > 0 ? uint64_t(gib * double(1ULL << 30)) / sizeof(struct simtemp_sample) : 0;
+    total -= total % kBatchSamples;
+    if (total < kMaxWindow || queries <= 0) {
+        uint64_t min_bytes = (kMaxWindow + kBatchSamples - 1) / kBatchSamples * kBatchSamples *
+                             sizeof(struct simtemp_sample);
+        fprintf(stderr, "simtemp_rec: bench needs -g >= %.6f (%" PRIu64 " samples) and -q >= 1\n",
+                std::ceil(double(min_bytes) / double(1ULL << 30) * 1e6) / 1e6, kMaxWindow);
+        return 1;
+    }
+
+    if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) {
+        fprintf(stderr, "simtemp_rec: cannot create %s: %s\n", dir.c_str(), strerror(errno));
+        return 1;
+    }
+    if (!list_segments(dir).empty()) {
+        fprintf(stderr, "simtemp_rec: %s already has segments, use an empty directory\n", dir.c_str());
+        return 1;
+    }
+    std::vector<struct simtemp_sample> batch(kBatchSamples);
+    std::mt19937 rng(42);
+
+    // 1. Ingest
+    printf("ingest: %" PRIu64 " samples (%.2f GiB), %" PRIu64 " MiB segments\n",
+           total, gib, segment_mib);
+    auto start = std::chrono::steady_clock::now();
+    {
+        SegmentWriter writer(dir, segment_mib << 20);
+        for (uint64_t n = 0; n < total; n += kBatchSamples) {
+            bench_fill(batch, n, rng);
+            if (!writer.append(batch.data(), batch.size()))
+                return 1;
+        }
+        if (!writer.close())
+            return 1;
+    }
+    double elapsed = seconds_since(start);
+    printf("  %.2f s, %.2f Msamples/s, %.1f MiB/s (includes fdatasync per segment)\n", elapsed,
+           total / elapsed / 1e6, total * sizeof(struct simtemp_sample) / elapsed / (1 << 20));
+
+    // 2. Random time-range queries, 1 s .. 60 s windows (1k .. 60k samples)
+    std::uniform_int_distribution<uint64_t> width(kMinWindow, kMaxWindow);
+    std::vector<double> lat;
+    uint64_t matched = 0;
+    for (int i = 0; i < queries; i++) {
+        Query q;
+        uint64_t w = width(rng);
+        uint64_t first = std::uniform_int_distribution<uint64_t>(0, total - w)(rng);
+        q.from_ns = first * 1000000ULL;
+        q.to_ns = (first + w - 1) * 1000000ULL;
+
+        auto t0 = std::chrono::steady_clock::now();
+        QueryStats st = run_query(dir, q, [](const struct simtemp_sample &) {});
+        lat.push_back(seconds_since(t0));
+        matched += st.matched;
+    }
+    printf("range query (%d x 1-60 s windows): p50 %.3f ms, p99 %.3f ms, %.0f samples/query\n",
+           queries, percentile(lat, 0.50) * 1e3, percentile(lat, 0.99) * 1e3,
+           double(matched) / queries);
+
+    // 3. "All samples above 40 C", with and without the min/max footer
+    for (bool use_index : {true, false}) {
+        Query q;
+        q.has_above = true;
+        q.above_mC = 40000;
+        q.use_index = use_index;
+
+        auto t0 = std::chrono::steady_clock::now();
+        QueryStats st = run_query(dir, q, [](const struct simtemp_sample &) {});
+        printf("above 40 C (%s): %.1f ms, %" PRIu64 " matches, %" PRIu64 " blocks scanned, %" PRIu64 " skipped\n",
+               use_index ? "index" : "full scan", seconds_since(t0) * 1e3, st.matched,
+               st.blocks_scanned, st.blocks_skipped);
+    }
+    printf("(page cache is warm after ingest; drop caches for cold numbers)\n");
+
+    if (!keep)
+        for (uint64_t index : list_segments(dir))
+            unlink(segment_path(dir, index).c_str());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+
+    std::string cmd = argv[1];
+    std::string dir = argv[2];
+    // Options follow the directory
+    argc -= 2;
+    argv += 2;
+
+    if (cmd == "record")
+        return cmd_record(dir, argc, argv);
+    if (cmd == "info")
+        return cmd_info(dir);
+    if (cmd == "query")
+        return cmd_query(dir, argc, argv, false);
+    if (cmd == "export")
+        return cmd_query(dir, argc, argv, true);
+    if (cmd == "bench")
+        return cmd_bench(dir, argc, argv);
+
+    usage();
+    return 1;
+}
@@ -0,0 +1,70 @@
+#ifndef SIMTEMP_REC_FORMAT_H
+#define SIMTEMP_REC_FORMAT_H
+
+//
+// On-disk format of simtemp_rec segments (seg-NNNNNN.stmp).
+//
+//   SegHeader                      64 bytes
+//   struct simtemp_sample[n]       append-only, grouped in blocks of
+//                                  'block_samples' records (last one partial)
+//   BlockInfo[nblocks]             footer: sparse index + per-block min/max
+//   SegTrailer                     last 64 bytes of the file
+//
+// The footer is written when the segment is closed (rotation or clean
+// exit). A segment without a valid trailer (crash, or still being written)
+// is still readable: the reader rebuilds the block index by scanning.
+//
+
+#include <cstdint>
+
+#include "../../kernel/nxp_simtemp_ioctl.h"
+
+namespace simtemp {
+namespace rec {
+
+constexpr uint64_t kSegMagic = 0x3130304345525453ULL;     // "STREC001"
+constexpr uint64_t kTrailerMagic = 0x444e454345525453ULL; // "STRECEND"
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint32_t kDefaultBlockSamples = 4096;            // 64 KiB of records
+
+struct SegHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;     // sizeof(struct simtemp_sample)
+    uint32_t block_samples;   // records per index block
+    uint32_t reserved0;
+    uint64_t segment_index;
+    uint8_t reserved[32];
+};
+
+// One entry per block: the sparse timestamp index and the min/max footer
+struct BlockInfo {
+    uint64_t first_ts_ns;
+    uint64_t last_ts_ns;
+    int32_t min_mC;
+    int32_t max_mC;
+    uint32_t count;
+    uint32_t alerts;          // records with SIMTEMP_FLAG_THRESHOLD_CROSSED
+};
+
+struct SegTrailer {
+    uint64_t magic;
+    uint64_t nsamples;
+    uint64_t nblocks;
+    uint64_t index_offset;    // file offset of BlockInfo[0]
+    uint64_t first_ts_ns;
+    uint64_t last_ts_ns;
+    int32_t min_mC;
+    int32_t max_mC;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(struct simtemp_sample) == 16, "record layout changed");
+static_assert(sizeof(SegHeader) == 64, "SegHeader layout changed");
+static_assert(sizeof(BlockInfo) == 32, "BlockInfo layout changed");
+static_assert(sizeof(SegTrailer) == 64, "SegTrailer layout changed");
+
+} // namespace rec
+} // namespace simtemp
+
+#endif // SIMTEMP_REC_FORMAT_H